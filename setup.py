@@ -57,12 +57,45 @@ with open("README.md") as f:
 extensions = [
     CTypes(
         "pseudoflow.libhpf",
-        ["src/pseudoflow/core/libhpf.c"],
-        depends=["src/pseudoflow/core/libhpf.h"],
-        export_symbols=["hpf_solve", "libfree"],
+        [
+            "src/pseudoflow/core/libhpf.c",
+            "src/pseudoflow/core/libhpf_float.c",
+            "src/pseudoflow/core/libhpf_int32.c",
+            "src/pseudoflow/core/libhpf_int64.c",
+        ],
+        depends=["src/pseudoflow/core/libhpf.h", "src/pseudoflow/core/libhpf.c"],
+        export_symbols=[
+            "hpf_solve" + suffix
+            for suffix in ["", "_float", "_int32", "_int64"]
+        ]
+        + [
+            name + suffix
+            for name in [
+                "hpf_solve_context",
+                "hpf_conductance",
+                "hpf_context_create",
+                "hpf_context_destroy",
+                "hpf_context_arena_high_water",
+                "hpf_context_set_arena_limit",
+                "hpf_context_set_warm_start",
+                "hpf_context_set_free_runs",
+                "hpf_context_set_breadth_first",
+                "hpf_context_set_open_interval_cap",
+                "hpf_context_max_queue_depth",
+                "hpf_context_set_threads",
+                "hpf_context_endpoint_overlap",
+                "hpf_context_set_seeds",
+                "hpf_context_set_parallel_pseudoflow",
+                "hpf_context_set_regions",
+                "hpf_context_set_undirected",
+            ]
+            for suffix in ["", "_float", "_int32", "_int64"]
+        ]
+        + ["libfree"],
         # include_dirs=["pseudoflow/core"],
         language="c99",
-        extra_compile_args=["-std=c99", "-O3"],
+        extra_compile_args=["-std=c99", "-O3", "-pthread"],
+        extra_link_args=["-pthread"],
     )
 ]
 
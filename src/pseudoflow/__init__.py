@@ -1 +1 @@
-from pseudoflow.python.hpf import hpf
+from pseudoflow.python.hpf import hpf, conductance
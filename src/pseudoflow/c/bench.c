@@ -0,0 +1,615 @@
+/*************************************************************************
+ * Benchmark for the HPF parametric cut solver                           *
+ * ***********************************************************************
+ * Generates a random integer weighted graph with conductance-like       *
+ * terminal arcs and solves it repeatedly with one capacity type         *
+ * instantiation of the solver (double, float, int32 or int64). The same *
+ * arguments generate the same instance for every capacity type.         *
+ *                                                                       *
+ * Usage:																 *
+ *	 bench [-cold] [-freeruns] [-bfs] [-cap <# intervals>]               *
+ *		[-threads <# threads>] [-seeds <# seeds>]                        *
+ *		[-ratioseeds <# seeds>] [-pseudoflownodes <# nodes>]             *
+ *		[-regionnodes <# nodes>] [-grid] [-native] [-undirected]         *
+ *		[-arenalimit <# bytes>] [-output <file>]                         *
+ *		<capacity type> <# nodes> <# edges> <seed> <repetitions>         *
+ *		[<lambda>]                                                       *
+ *                                                                       *
+ * Without lambda the full parametric problem is solved. With lambda a   *
+ * single minimum cut is solved at that value, which isolates the arc    *
+ * scans of the pseudoflow kernel (processRoot / findWeakNode). -cold    *
+ * starts every subproblem from zero flow instead of the flows of the    *
+ * solve at the upper end of its interval. -freeruns continues the solve *
+ * of the lower bound problem into the upper bound problem instead of    *
+ * solving it from scratch. -bfs solves the open intervals breadth first *
+ * and -cap keeps the source sets of at most that many open intervals.   *
+ * -threads solves the open intervals with that many worker threads and, *
+ * without -freeruns, the lower and upper bound problems at the same     *
+ * time. -seeds solves that many evenly spaced lambda values up front    *
+ * and starts the parametric cut from the intervals between them,        *
+ * -ratioseeds places them at quantiles of the terminal arc ratios.      *
+ * -pseudoflownodes solves subproblems with at least that many nodes by  *
+ * a parallel pseudoflow run on the threads of -threads. -regionnodes    *
+ * starts problems with at least that many nodes from the flows of one   *
+ * block of nodes per thread, solved in parallel. -grid generates a 3D   *
+ * grid instead of a random graph (see below). -native passes the edges, *
+ * node weights and sink weights to hpf_conductance, which builds the    *
+ * terminal arcs itself; the breakpoints are the same. -undirected passes *
+ * each edge once, as an undirected edge (hpf_context_set_undirected),   *
+ * instead of as two arcs. hpf_conductance always stores edges once.     *
+ * -arenalimit caps the solver arena (hpf_context_set_arena_limit); a    *
+ * solve that exceeds it is reported as failed. -output writes the sorted *
+ * breakpoints and the lambda of every node of the last solve to a file, *
+ * which does not depend on the order of the solve (see make test).      *
+ * Solve times are wall-clock times.                                     *
+ *                                                                       *
+ * The solver reports its progress on stdout; the benchmark result is    *
+ * written to stderr. Run one capacity type per process, the reported    *
+ * peak resident set size covers the whole process.                      *
+ *                                                                       *
+ * Instance:                                                             *
+ * - node 0 is the source and node <# nodes> + 1 the sink                *
+ * - with -grid the nodes are a cube of side round(cbrt(<# nodes>)),     *
+ *		numbered in raster order, and the edges join the 6-neighbours;   *
+ *		<# edges> is ignored                                             *
+ * - every edge {u, v} gets an integer weight w in 1..10 and becomes the *
+ *		arcs (u, v) and (v, u) with constant capacity w                  *
+ * - every node i gets a source arc with multiplier deg(i) and a sink    *
+ *		arc with an integer constant capacity in 1..40                   *
+ *************************************************************************/
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include <sys/resource.h>
+#include "../core/libhpf.h"
+
+typedef struct BenchResult
+{
+	int numBreakpoints;
+	double checksum;
+	double minSolve;
+	double sumSolve;
+	int stats[5];
+	size_t arenaHighWater;
+	int maxQueueDepth;
+	double endpointOverlap;
+	int error;
+	// breakpoints and cuts of the last solve, the cut of node i of the graph is cuts[firstNode + i]
+	double *breakpoints;
+	double *cuts;
+	int firstNode;
+} BenchResult;
+
+static unsigned long long randomState;
+
+static unsigned int randomInt(unsigned int low, unsigned int high)
+/*************************************************************************
+randomInt - xorshift64, uniform in [low, high]. Independent of the C
+library so every capacity type sees the same instance on every platform.
+*************************************************************************/
+{
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 7;
+	randomState ^= randomState << 17;
+	return low + (unsigned int) (randomState % (high - low + 1));
+}
+
+static void addEdge(double *arcMatrix, int *arcCount, double *degree, int u, int v, int w)
+/*************************************************************************
+addEdge - The arcs (u, v) and (v, u) of an edge with weight w
+*************************************************************************/
+{
+	arcMatrix[*arcCount * 4 + 0] = u;
+	arcMatrix[*arcCount * 4 + 1] = v;
+	arcMatrix[*arcCount * 4 + 2] = w;
+	arcMatrix[*arcCount * 4 + 3] = 0;
+	++(*arcCount);
+
+	arcMatrix[*arcCount * 4 + 0] = v;
+	arcMatrix[*arcCount * 4 + 1] = u;
+	arcMatrix[*arcCount * 4 + 2] = w;
+	arcMatrix[*arcCount * 4 + 3] = 0;
+	++(*arcCount);
+
+	degree[u] += w;
+	degree[v] += w;
+}
+
+static double * generateInstance(int numGraphNodes, int numEdges, int grid, unsigned long long seed,
+	int *numNodes, int *numArcs, double lambdaRange[2])
+/*************************************************************************
+generateInstance
+*************************************************************************/
+{
+	int i, u, v, w, q, x, y, z;
+	int side = 0;
+	int source = 0;
+	int sink;
+	int arcCount = 0;
+	int maxSinkCapacity = 1;
+	double *degree;
+	double *arcMatrix;
+
+	randomState = seed * 2654435761ULL + 88172645463325252ULL;
+
+	if (grid)
+	{
+		while ((side + 1) * (side + 1) * (side + 1) <= numGraphNodes
+			|| (side + 1) * (side + 1) * (side + 1) - numGraphNodes < numGraphNodes - side * side * side)
+		{
+			++side;
+		}
+		numGraphNodes = side * side * side;
+		numEdges = 3 * numGraphNodes;
+	}
+	sink = numGraphNodes + 1;
+
+	*numNodes = numGraphNodes + 2;
+	if ((degree = (double *)calloc(*numNodes, sizeof(double))) == NULL ||
+		(arcMatrix = (double *)malloc((2 * (size_t) numEdges + 2 * (size_t) numGraphNodes) * 4 * sizeof(double))) == NULL)
+	{
+		printf("Could not allocate memory.\n");
+		exit(0);
+	}
+
+	if (grid)
+	{
+		for (i = 0; i < numGraphNodes; ++i)
+		{
+			x = i % side;
+			y = (i / side) % side;
+			z = i / (side * side);
+			if (x + 1 < side)
+			{
+				addEdge(arcMatrix, &arcCount, degree, i + 1, i + 2, randomInt(1, 10));
+			}
+			if (y + 1 < side)
+			{
+				addEdge(arcMatrix, &arcCount, degree, i + 1, i + 1 + side, randomInt(1, 10));
+			}
+			if (z + 1 < side)
+			{
+				addEdge(arcMatrix, &arcCount, degree, i + 1, i + 1 + side * side, randomInt(1, 10));
+			}
+		}
+	}
+
+	for (i = 0; !grid && i < numEdges; ++i)
+	{
+		u = randomInt(1, numGraphNodes);
+		v = randomInt(1, numGraphNodes);
+		w = randomInt(1, 10);
+		if (u == v)
+		{
+			continue;
+		}
+
+		addEdge(arcMatrix, &arcCount, degree, u, v, w);
+	}
+
+	for (i = 1; i <= numGraphNodes; ++i)
+	{
+		q = randomInt(1, 40);
+		if (q > maxSinkCapacity)
+		{
+			maxSinkCapacity = q;
+		}
+
+		arcMatrix[arcCount * 4 + 0] = source;
+		arcMatrix[arcCount * 4 + 1] = i;
+		arcMatrix[arcCount * 4 + 2] = 0;
+		arcMatrix[arcCount * 4 + 3] = degree[i] > 0 ? degree[i] : 1;
+		++arcCount;
+
+		arcMatrix[arcCount * 4 + 0] = i;
+		arcMatrix[arcCount * 4 + 1] = sink;
+		arcMatrix[arcCount * 4 + 2] = q;
+		arcMatrix[arcCount * 4 + 3] = 0;
+		++arcCount;
+	}
+
+	/* every degree is at least 1, so all nodes join the source set by lambda = max q */
+	lambdaRange[0] = 0;
+	lambdaRange[1] = maxSinkCapacity;
+	*numArcs = arcCount;
+
+	free(degree);
+	return arcMatrix;
+}
+
+static double * conductanceInput(int numNodes, int numArcs, const double *arcMatrix, int *numGraphEdges,
+	double **nodeWeights, double **sinkWeights)
+/*************************************************************************
+conductanceInput - The edges (u - 1, v - 1, w) and the node and sink
+weights of a generated instance, for hpf_conductance
+*************************************************************************/
+{
+	int i;
+	int numGraphNodes = numNodes - 2;
+	double *edgeMatrix;
+
+	if ((edgeMatrix = (double *)malloc((numArcs / 2 + 1) * 3 * sizeof(double))) == NULL ||
+		(*nodeWeights = (double *)malloc((numGraphNodes + 1) * sizeof(double))) == NULL ||
+		(*sinkWeights = (double *)malloc((numGraphNodes + 1) * sizeof(double))) == NULL)
+	{
+		printf("Could not allocate memory.\n");
+		exit(0);
+	}
+
+	/* addEdge writes both arcs of an edge next to each other, ahead of the terminal arcs */
+	*numGraphEdges = 0;
+	for (i = 0; i < numArcs; ++i)
+	{
+		if (arcMatrix[i * 4 + 0] == 0)
+		{
+			(*nodeWeights)[(int) arcMatrix[i * 4 + 1] - 1] = arcMatrix[i * 4 + 3];
+		}
+		else if (arcMatrix[i * 4 + 1] == numNodes - 1)
+		{
+			(*sinkWeights)[(int) arcMatrix[i * 4 + 0] - 1] = arcMatrix[i * 4 + 2];
+		}
+		else
+		{
+			edgeMatrix[*numGraphEdges * 3 + 0] = arcMatrix[i * 4 + 0] - 1;
+			edgeMatrix[*numGraphEdges * 3 + 1] = arcMatrix[i * 4 + 1] - 1;
+			edgeMatrix[*numGraphEdges * 3 + 2] = arcMatrix[i * 4 + 2];
+			++*numGraphEdges;
+			++i;
+		}
+	}
+
+	return edgeMatrix;
+}
+
+static void keepOneArcPerEdge(int numNodes, double *arcMatrix, int *numArcs)
+/*************************************************************************
+keepOneArcPerEdge - Drop the arc (v, u) of every edge {u, v} of a
+generated instance, for the undirected edge mode
+*************************************************************************/
+{
+	int i;
+	int numKept = 0;
+
+	/* addEdge writes both arcs of an edge next to each other, ahead of the terminal arcs */
+	for (i = 0; i < *numArcs; ++i)
+	{
+		memmove(&arcMatrix[numKept * 4], &arcMatrix[i * 4], 4 * sizeof(double));
+		++numKept;
+		if (arcMatrix[i * 4 + 0] != 0 && arcMatrix[i * 4 + 1] != numNodes - 1)
+		{
+			++i;
+		}
+	}
+	*numArcs = numKept;
+}
+
+static int compareDouble(const void *a, const void *b)
+/*************************************************************************
+compareDouble - qsort comparator of doubles
+*************************************************************************/
+{
+	double x = *(const double *) a;
+	double y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+static void writeOutput(const char *fileName, int numGraphNodes, const BenchResult *result)
+/*************************************************************************
+writeOutput - Write the breakpoints in increasing order and the lambda of
+every node of the graph. Both are the same for every setting that does
+not change the cuts, in the order the CLI writes them.
+*************************************************************************/
+{
+	FILE *out;
+	double *breakpoints;
+	int i;
+
+	if ((out = fopen(fileName, "w")) == NULL)
+	{
+		printf("Could not open file %s\n", fileName);
+		exit(0);
+	}
+	if ((breakpoints = (double *)malloc((result->numBreakpoints + 1) * sizeof(double))) == NULL)
+	{
+		printf("Could not allocate memory.\n");
+		exit(0);
+	}
+	memcpy(breakpoints, result->breakpoints, result->numBreakpoints * sizeof(double));
+	qsort(breakpoints, result->numBreakpoints, sizeof(double), compareDouble);
+
+	fprintf(out, "p %d\nl", result->numBreakpoints);
+	for (i = 0; i < result->numBreakpoints; ++i)
+	{
+		fprintf(out, " %.9f", breakpoints[i]);
+	}
+	fprintf(out, "\n");
+	for (i = 0; i < numGraphNodes; ++i)
+	{
+		fprintf(out, "n %d %.6f\n", i, result->cuts[result->firstNode + i]);
+	}
+
+	fclose(out);
+	free(breakpoints);
+}
+
+/*************************************************************************
+BENCH_RUN - Define runBench<suffix>, which solves the instance repetitions
+times with the instantiation of the given suffix. With an edgeMatrix the
+instance is solved by hpf_conductance instead of hpf_solve_context.
+*************************************************************************/
+#define BENCH_RUN(suffix) \
+static void runBench##suffix(int numNodes, int numArcs, double *arcMatrix, double lambdaRange[2], \
+	int repetitions, int warmStart, int freeRuns, int breadthFirst, int cap, int numThreads, \
+	int numSeeds, int seedsFromRatios, int parallelPseudoflowNodes, int regionNodes, int undirected, \
+	size_t arenaLimit, int numGraphEdges, double *edgeMatrix, double *nodeWeights, double *sinkWeights, BenchResult *result) \
+{ \
+	HpfContext##suffix *ctx = hpf_context_create##suffix(); \
+	double *cuts; \
+	double *breakpoints; \
+	double times[3]; \
+	int i; \
+	\
+	if (ctx == NULL) \
+	{ \
+		result->error = HPF_ERROR_OUT_OF_MEMORY; \
+		return; \
+	} \
+	hpf_context_set_warm_start##suffix(ctx, warmStart); \
+	hpf_context_set_free_runs##suffix(ctx, freeRuns); \
+	hpf_context_set_breadth_first##suffix(ctx, breadthFirst); \
+	hpf_context_set_open_interval_cap##suffix(ctx, cap); \
+	hpf_context_set_threads##suffix(ctx, numThreads); \
+	hpf_context_set_seeds##suffix(ctx, numSeeds, seedsFromRatios); \
+	hpf_context_set_parallel_pseudoflow##suffix(ctx, parallelPseudoflowNodes); \
+	hpf_context_set_regions##suffix(ctx, regionNodes); \
+	hpf_context_set_undirected##suffix(ctx, undirected); \
+	hpf_context_set_arena_limit##suffix(ctx, arenaLimit); \
+	for (i = 0; i < repetitions && result->error == HPF_OK; ++i) \
+	{ \
+		if (edgeMatrix != NULL) \
+		{ \
+			result->error = hpf_conductance##suffix(ctx, numNodes - 2, numGraphEdges, edgeMatrix, nodeWeights, sinkWeights, \
+				0, NULL, lambdaRange, &result->numBreakpoints, &cuts, &breakpoints, result->stats, times); \
+		} \
+		else \
+		{ \
+			result->error = hpf_solve_context##suffix(ctx, numNodes, numArcs, 0, numNodes - 1, arcMatrix, lambdaRange, 1, \
+				&result->numBreakpoints, &cuts, &breakpoints, result->stats, times); \
+		} \
+		if (result->error != HPF_OK) \
+		{ \
+			break; \
+		} \
+		\
+		if (i == 0 || times[2] < result->minSolve) \
+		{ \
+			result->minSolve = times[2]; \
+		} \
+		result->sumSolve += times[2]; \
+		\
+		if (i + 1 == repetitions) \
+		{ \
+			for (int j = 0; j < result->numBreakpoints; ++j) \
+			{ \
+				result->checksum += breakpoints[j]; \
+			} \
+			result->breakpoints = breakpoints; \
+			result->cuts = cuts; \
+			result->firstNode = edgeMatrix != NULL ? 0 : 1; \
+		} \
+		else \
+		{ \
+			free(cuts); \
+			free(breakpoints); \
+		} \
+	} \
+	\
+	result->arenaHighWater = hpf_context_arena_high_water##suffix(ctx); \
+	result->maxQueueDepth = hpf_context_max_queue_depth##suffix(ctx); \
+	result->endpointOverlap = hpf_context_endpoint_overlap##suffix(ctx); \
+	hpf_context_destroy##suffix(ctx); \
+}
+
+BENCH_RUN()
+BENCH_RUN(_float)
+BENCH_RUN(_int32)
+BENCH_RUN(_int64)
+
+int main(int argc, char **argv)
+/*************************************************************************
+main - Main function
+*************************************************************************/
+{
+	int warmStart = 1;
+	int freeRuns = 0;
+	int breadthFirst = 0;
+	int cap = 0;
+	int numThreads = 1;
+	int numSeeds = 0;
+	int seedsFromRatios = 0;
+	int parallelPseudoflowNodes = 0;
+	int regionNodes = 0;
+	int grid = 0;
+	int native = 0;
+	int undirected = 0;
+	size_t arenaLimit = 0;
+	const char *outputFile = NULL;
+
+	for ( ; argc > 1 && argv[1][0] == '-'; --argc, ++argv)
+	{
+		if (strcmp(argv[1], "-cold") == 0)
+		{
+			warmStart = 0;
+		}
+		else if (strcmp(argv[1], "-freeruns") == 0)
+		{
+			freeRuns = 1;
+		}
+		else if (strcmp(argv[1], "-bfs") == 0)
+		{
+			breadthFirst = 1;
+		}
+		else if (strcmp(argv[1], "-cap") == 0 && argc > 2)
+		{
+			cap = atoi(argv[2]);
+			--argc;
+			++argv;
+		}
+		else if (strcmp(argv[1], "-threads") == 0 && argc > 2)
+		{
+			numThreads = atoi(argv[2]);
+			--argc;
+			++argv;
+		}
+		else if ((strcmp(argv[1], "-seeds") == 0 || strcmp(argv[1], "-ratioseeds") == 0) && argc > 2)
+		{
+			seedsFromRatios = strcmp(argv[1], "-ratioseeds") == 0;
+			numSeeds = atoi(argv[2]);
+			--argc;
+			++argv;
+		}
+		else if (strcmp(argv[1], "-regionnodes") == 0 && argc > 2)
+		{
+			regionNodes = atoi(argv[2]);
+			--argc;
+			++argv;
+		}
+		else if (strcmp(argv[1], "-grid") == 0)
+		{
+			grid = 1;
+		}
+		else if (strcmp(argv[1], "-native") == 0)
+		{
+			native = 1;
+		}
+		else if (strcmp(argv[1], "-undirected") == 0)
+		{
+			undirected = 1;
+		}
+		else if (strcmp(argv[1], "-arenalimit") == 0 && argc > 2)
+		{
+			arenaLimit = (size_t) strtoull(argv[2], NULL, 10);
+			--argc;
+			++argv;
+		}
+		else if (strcmp(argv[1], "-output") == 0 && argc > 2)
+		{
+			outputFile = argv[2];
+			--argc;
+			++argv;
+		}
+		else if (strcmp(argv[1], "-pseudoflownodes") == 0 && argc > 2)
+		{
+			parallelPseudoflowNodes = atoi(argv[2]);
+			--argc;
+			++argv;
+		}
+		else
+		{
+			printf("Unknown option %s\n", argv[1]);
+			exit(0);
+		}
+	}
+
+	if (argc != 6 && argc != 7)
+	{
+		printf("Incorrect number of input arguments. Call bench [-cold] [-freeruns] [-bfs] [-cap intervals] [-threads threads] [-seeds seeds] [-ratioseeds seeds] [-pseudoflownodes nodes] [-regionnodes nodes] [-grid] [-native] [-undirected] [-arenalimit bytes] [-output file] capacityType numNodes numEdges seed repetitions [lambda]\n");
+		exit(0);
+	}
+
+	const char *capacityType = argv[1];
+	int numGraphNodes = atoi(argv[2]);
+	int numEdges = atoi(argv[3]);
+	unsigned long long seed = strtoull(argv[4], NULL, 10);
+	int repetitions = atoi(argv[5]);
+
+	int numNodes;
+	int numArcs;
+	double lambdaRange[2];
+	double *arcMatrix = generateInstance(numGraphNodes, numEdges, grid, seed, &numNodes, &numArcs, lambdaRange);
+
+	int numGraphEdges = 0;
+	double *edgeMatrix = NULL;
+	double *nodeWeights = NULL;
+	double *sinkWeights = NULL;
+	if (native)
+	{
+		edgeMatrix = conductanceInput(numNodes, numArcs, arcMatrix, &numGraphEdges, &nodeWeights, &sinkWeights);
+	}
+	if (undirected)
+	{
+		keepOneArcPerEdge(numNodes, arcMatrix, &numArcs);
+	}
+
+	if (argc == 7)
+	{
+		lambdaRange[0] = atof(argv[6]);
+		lambdaRange[1] = lambdaRange[0];
+	}
+
+	BenchResult result;
+	struct rusage usage;
+
+	memset(&result, 0, sizeof(result));
+
+	if (strcmp(capacityType, "double") == 0)
+	{
+		runBench(numNodes, numArcs, arcMatrix, lambdaRange, repetitions, warmStart, freeRuns, breadthFirst, cap, numThreads, numSeeds, seedsFromRatios, parallelPseudoflowNodes, regionNodes, undirected, arenaLimit, numGraphEdges, edgeMatrix, nodeWeights, sinkWeights, &result);
+	}
+	else if (strcmp(capacityType, "float") == 0)
+	{
+		runBench_float(numNodes, numArcs, arcMatrix, lambdaRange, repetitions, warmStart, freeRuns, breadthFirst, cap, numThreads, numSeeds, seedsFromRatios, parallelPseudoflowNodes, regionNodes, undirected, arenaLimit, numGraphEdges, edgeMatrix, nodeWeights, sinkWeights, &result);
+	}
+	else if (strcmp(capacityType, "int32") == 0)
+	{
+		runBench_int32(numNodes, numArcs, arcMatrix, lambdaRange, repetitions, warmStart, freeRuns, breadthFirst, cap, numThreads, numSeeds, seedsFromRatios, parallelPseudoflowNodes, regionNodes, undirected, arenaLimit, numGraphEdges, edgeMatrix, nodeWeights, sinkWeights, &result);
+	}
+	else if (strcmp(capacityType, "int64") == 0)
+	{
+		runBench_int64(numNodes, numArcs, arcMatrix, lambdaRange, repetitions, warmStart, freeRuns, breadthFirst, cap, numThreads, numSeeds, seedsFromRatios, parallelPseudoflowNodes, regionNodes, undirected, arenaLimit, numGraphEdges, edgeMatrix, nodeWeights, sinkWeights, &result);
+	}
+	else
+	{
+		printf("Unknown capacity type %s. Use double, float, int32 or int64\n", capacityType);
+		exit(0);
+	}
+
+	if (result.error != HPF_OK)
+	{
+		fprintf(stderr, "%-6s solve failed: %s\n", capacityType,
+			result.error == HPF_ERROR_ARENA_LIMIT ? "arena limit exceeded" :
+			result.error == HPF_ERROR_INVALID_INPUT ? "capacity overflow" : "out of memory");
+		free(arcMatrix);
+		free(edgeMatrix);
+		free(nodeWeights);
+		free(sinkWeights);
+		return 1;
+	}
+
+	if (outputFile != NULL && repetitions > 0)
+	{
+		writeOutput(outputFile, numNodes - 2, &result);
+	}
+
+	getrusage(RUSAGE_SELF, &usage);
+
+	fprintf(stderr, "%-6s %s%s%s%s%s cap %d threads %d seeds %d%s parallel pseudoflow nodes %d region nodes %d%s nodes %d arcs %d breakpoints %d checksum %.9f solve min %.3lf s mean %.3lf s "
+		"arc scans %d mergers %d pushes %d relabels %d gaps %d arc scans/s %.3g arena %lu KiB queue depth %d endpoint overlap %.3lf s max RSS %ld KiB\n",
+		capacityType, warmStart ? "warm" : "cold", native ? " native" : "", undirected ? " undirected" : "", freeRuns ? " free runs" : "", breadthFirst ? " bfs" : "", cap, numThreads,
+		numSeeds, numSeeds > 0 && seedsFromRatios ? " ratios" : "", parallelPseudoflowNodes, regionNodes, grid ? " grid" : "", numNodes, numArcs,
+		result.numBreakpoints, result.checksum, result.minSolve, repetitions > 0 ? result.sumSolve / repetitions : 0.0,
+		result.stats[0], result.stats[1], result.stats[2], result.stats[3], result.stats[4],
+		result.minSolve > 0 ? result.stats[0] / result.minSolve : 0.0,
+		(unsigned long) (result.arenaHighWater / 1024), result.maxQueueDepth, result.endpointOverlap, (long) usage.ru_maxrss);
+
+	free(result.breakpoints);
+	free(result.cuts);
+	free(arcMatrix);
+	free(edgeMatrix);
+	free(nodeWeights);
+	free(sinkWeights);
+
+	return 0;
+}
@@ -37,6 +37,15 @@
  * 1. Compile hpf.c with a C-compiler (e.g. gcc)						 *
  * 2. To execute within bash environment:								 *
  *	 <name compiled hpf executable> <path input file> <path output file> *
+ *		[<# threads> [<parallel pseudoflow nodes> [<region nodes>		 *
+ *		[<# seeds>]]]]													 *
+ * The optional number of threads solves the lambda intervals in		 *
+ * parallel, 0 uses all processors. Subproblems with at least the		 *
+ * optional number of parallel pseudoflow nodes are solved by a			 *
+ * parallel pseudoflow run, and problems with at least the optional		 *
+ * number of region nodes start from the flows of blocks of nodes		 *
+ * solved in parallel. The optional number of seeds solves evenly		 *
+ * spaced lambda values first. The output does not depend on any of them.*
  *                                                                       *
  * INPUT FILE                                                            *
  * **********                                                            *
@@ -67,7 +76,8 @@
  * s <# arc scans> <# mergers> <# pushes> <# relabels > <# gap >		 *
  * p <number of lambda intervals = k>									 *
  * l <lambda upperbound interval 1> ... <lambda upperbound interval k>   *
- * n <node-id> <sourceset indicator intval 1 > .. <indicator intval k>   *
+ * n <node-id> <lambda upperbound of the first interval with the node	 *
+ *		in the source set, inf if it is in none>						 *
  *                                                                       *
  * Set-up                                                                *
  * ******                                                                *
@@ -367,9 +377,9 @@ main - Main function
 *************************************************************************/
 {
 	// check number of input arguments
-	if (argc != 3)
+	if (argc < 3 || argc > 7)
 	{
-		printf("Incorrect number of input arguments. Call hpf.exe inputFile outputFile\n");
+		printf("Incorrect number of input arguments. Call hpf.exe inputFile outputFile [numThreads [parallelPseudoflowNodes [regionNodes [numSeeds]]]]\n");
 		exit(0);
 	}
 
@@ -402,12 +412,46 @@ main - Main function
 	int stats[5];
 	double times[3];
 
-	hpf_solve(numNodes, numArcs, source, sink, arcMatrix, lambdaRange, roundNegativeCapacity,
-		&numBreakpoints, &cuts, &breakpoints, stats, times );
+	HpfContext *ctx = hpf_context_create();
+	if (ctx == NULL)
+	{
+		printf("Out of memory\n");
+		exit(0);
+	}
+	if (argc >= 4)
+	{
+		hpf_context_set_threads(ctx, atoi(argv[3]));
+	}
+	if (argc >= 5)
+	{
+		hpf_context_set_parallel_pseudoflow(ctx, atoi(argv[4]));
+	}
+	if (argc >= 6)
+	{
+		hpf_context_set_regions(ctx, atoi(argv[5]));
+	}
+	if (argc == 7)
+	{
+		hpf_context_set_seeds(ctx, atoi(argv[6]), 0);
+	}
+
+	if (hpf_solve_context(ctx, numNodes, numArcs, source, sink, arcMatrix, lambdaRange, roundNegativeCapacity,
+		&numBreakpoints, &cuts, &breakpoints, stats, times ) != HPF_OK)
+	{
+		printf("Out of memory\n");
+		hpf_context_destroy(ctx);
+		free(arcMatrix);
+		exit(0);
+	}
 
 	printf("Stats: [%d, %d, %d, %d, %d]\n", stats[0],stats[1],stats[2],stats[3],stats[4]);
 	printf("times: [%lf, %lf, %lf]\n", times[0],times[1],times[2]);
 	printf("Num breakpoints: %d\n", numBreakpoints);
+	printf("Arena high-water mark: %lu bytes\n", (unsigned long) hpf_context_arena_high_water(ctx));
+	printf("Max queue depth: %d\n", hpf_context_max_queue_depth(ctx));
+	printf("Endpoint solve overlap: %lf s\n", hpf_context_endpoint_overlap(ctx));
+
+	hpf_context_destroy(ctx);
 	// printf("breakpoints:\n");
 	// for (int i = 0; i < numBreakpoints; ++i)
 	// {
@@ -101,14 +101,32 @@
  *************************************************************************/
 
 #define _CRTDBG_MAP_ALLOC
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L // localtime_r and asctime_r
+#endif
 #include "stdio.h"
 #include <assert.h>
 //#include <sys/time.h>
 //#include <sys/resource.h>
 #include "stdlib.h"
+#include "string.h"
 #include "time.h"
+#include <pthread.h>
+#include <setjmp.h>
+#include <math.h>
+#include <unistd.h>
+#include "libhpf.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HPF_X86_SIMD
+#endif
 //#include <unistd.h>
 
+#ifdef _WIN32
+#define localtime_r(timer, result) localtime_s((result), (timer))
+#define asctime_r(tm, buf) (asctime_s((buf), sizeof(buf), (tm)) == 0 ? (buf) : "")
+#endif
+
 /*************************************************************************
 Definitions
 *************************************************************************/
@@ -120,65 +138,381 @@ typedef long int lint;
 typedef long long int llint;
 typedef unsigned long long int ullint;
 
+/* Capacity type. The solver is instantiated once per capacity type: this
+file is the double instantiation, and libhpf_float.c, libhpf_int32.c and
+libhpf_int64.c include it with HPF_CAPACITY_FLOAT, HPF_CAPACITY_INT32 or
+HPF_CAPACITY_INT64 defined. The exported functions of an instantiation carry
+its suffix (hpf_solve_int64, ...), see libhpf.h.
+Integer capacities require integer constants and multipliers. Lambda is then
+kept as a reduced fraction num / den and every subproblem is solved on
+capacities scaled by den, so the cut functions of two source sets intersect
+exactly. CAPACITY_LIMIT bounds the magnitude of a scaled capacity. */
+#if defined(HPF_CAPACITY_FLOAT)
+typedef float Capacity;
+#define HPF_SUFFIX _float
+#elif defined(HPF_CAPACITY_INT32)
+typedef int Capacity;
+#define HPF_SUFFIX _int32
+#define HPF_INTEGER_CAPACITY
+#define CAPACITY_LIMIT 1E9
+#elif defined(HPF_CAPACITY_INT64)
+typedef llint Capacity;
+#define HPF_SUFFIX _int64
+#define HPF_INTEGER_CAPACITY
+#define CAPACITY_LIMIT 4E18
+#else
+typedef double Capacity;
+#define HPF_SUFFIX
+#define HPF_DOUBLE_CAPACITY
+#endif
+
+#define HPF_CONCAT_(name, suffix) name##suffix
+#define HPF_CONCAT(name, suffix) HPF_CONCAT_(name, suffix)
+
+#define HpfContext HPF_CONCAT(HpfContext, HPF_SUFFIX)
+#define hpf_context_create HPF_CONCAT(hpf_context_create, HPF_SUFFIX)
+#define hpf_context_destroy HPF_CONCAT(hpf_context_destroy, HPF_SUFFIX)
+#define hpf_context_arena_high_water HPF_CONCAT(hpf_context_arena_high_water, HPF_SUFFIX)
+#define hpf_context_set_arena_limit HPF_CONCAT(hpf_context_set_arena_limit, HPF_SUFFIX)
+#define hpf_context_set_warm_start HPF_CONCAT(hpf_context_set_warm_start, HPF_SUFFIX)
+#define hpf_context_set_free_runs HPF_CONCAT(hpf_context_set_free_runs, HPF_SUFFIX)
+#define hpf_context_set_breadth_first HPF_CONCAT(hpf_context_set_breadth_first, HPF_SUFFIX)
+#define hpf_context_set_open_interval_cap HPF_CONCAT(hpf_context_set_open_interval_cap, HPF_SUFFIX)
+#define hpf_context_max_queue_depth HPF_CONCAT(hpf_context_max_queue_depth, HPF_SUFFIX)
+#define hpf_context_set_threads HPF_CONCAT(hpf_context_set_threads, HPF_SUFFIX)
+#define hpf_context_endpoint_overlap HPF_CONCAT(hpf_context_endpoint_overlap, HPF_SUFFIX)
+#define hpf_context_set_seeds HPF_CONCAT(hpf_context_set_seeds, HPF_SUFFIX)
+#define hpf_context_set_parallel_pseudoflow HPF_CONCAT(hpf_context_set_parallel_pseudoflow, HPF_SUFFIX)
+#define hpf_context_set_regions HPF_CONCAT(hpf_context_set_regions, HPF_SUFFIX)
+#define hpf_context_set_undirected HPF_CONCAT(hpf_context_set_undirected, HPF_SUFFIX)
+#define hpf_solve_context HPF_CONCAT(hpf_solve_context, HPF_SUFFIX)
+#define hpf_solve HPF_CONCAT(hpf_solve, HPF_SUFFIX)
+#define hpf_conductance HPF_CONCAT(hpf_conductance, HPF_SUFFIX)
+
+#ifdef HPF_INTEGER_CAPACITY
+typedef struct Lambda
+{
+	llint num;
+	llint den;
+} Lambda;
+#else
+typedef double Lambda;
+#endif
+
+/* Coefficient of a cut function. A cut function sums the arcs of the whole
+super graph and breakpoints come from the difference of two of them, so
+float capacities sum in double. */
+#ifdef HPF_CAPACITY_FLOAT
+typedef double CutCoefficient;
+#else
+typedef Capacity CutCoefficient;
+#endif
+
+/* Nodes and arcs refer to each other by 32-bit index: the index of a node in
+the node list of its problem and of an arc in the arc list being solved.
+NONE marks a missing node or arc. */
+#define NONE ((uint) -1)
+
+/* Source set indicators hold one bit per node of the super graph, packed
+into 64-bit words. The bits past the last node are kept zero, so sets are
+counted and compared a word at a time (see sourceSetSize and
+sourceSetDifference). */
+typedef ullint SetWord;
+#define SET_WORD_BITS 64
+
 typedef struct Arc
 	{
-		struct Node *from;
-		struct Node *to;
-		double flow;
-		double capacity;
-		double constant;
-		double multiplier;
+		uint from;
+		uint to;
+		Capacity flow;
+		Capacity capacity;
+		Capacity constant;
+		Capacity multiplier;
 		uint direction;
+		uint superArc;
 	} Arc;
 
+/* Node state is split by access pattern. Node holds the tree links and
+excess used by the pseudoflow kernel, the labels of a solve are a dense
+array in the context (findWeakNode compares the labels of arc endpoints),
+and NodeInfo holds the construction and output data of a problem. */
 typedef struct Node
 	{
-		struct Node *parent;
-		struct Node *childList;
-		struct Node *nextScan;
-		Arc **outOfTree;
-		Arc *arcToParent;
-		struct Node *next;
-		struct Node *prev;
-		double excess;
-		uint visited;
-		uint numAdjacent;
-		uint number;
-		int originalIndex;
-		uint label;
+		Capacity excess;
+		uint parent;
+		uint childList;
+		uint nextScan;
+		uint arcToParent;
+		uint next;
+#ifdef PREV_CHILDLIST
+		uint prev;
+#endif
 		uint numOutOfTree;
 		uint nextArc;
 	} Node;
 
+typedef struct NodeInfo
+	{
+		int originalIndex;
+		uint numAdjacent;
+	} NodeInfo;
+
 typedef struct CutProblem
 {
 	uint numNodesInList;
-  uint numSourceSet;
-	uint numSinkSet;
 	uint numArcs;
 	uint solved;
-	double lambdaValue;
+	Lambda lambdaValue;
 	Arc *arcList;
 	Node *nodeList;
-	double cutValue;
-	Node *sourceSet;
-	Node *sinkSet;
-    char *optimalSourceSetIndicator;
+	NodeInfo *nodeInfo;
+	/* capacities of the source and sink arcs of each node of the list at
+	lambdaValue, summed over the arcs of the nodes contracted into the
+	terminals. arcList holds only the arcs between free nodes. */
+	Capacity *sourceCapacity;
+	Capacity *sinkCapacity;
+	Capacity cutValue;
+	/* chain entries the graph is contracted between: the nodes that join the
+	source set at lowEntry or before are contracted into the source, those
+	that join at highEntry are free, the others are contracted into the sink.
+	NONE for a graph of all nodes. */
+	uint lowEntry;
+	uint highEntry;
+	/* source set indicator of the free nodes of the graph, by position in its
+	node list (see sourceSetIndex), and its number of words. It is freed once
+	the problem has entered the chain (see ChainEntry). */
+    SetWord *optimalSourceSetIndicator;
+	uint setWords;
+	// entry of the source set in the chain, NONE until the problem is the endpoint of an interval
+	uint entry;
+	/* whether the optimal source set is the maximal one at lambdaValue,
+	and the number of open intervals that hold the problem */
+	uint maximalSet;
+	uint references;
+	unsigned char *warmStartArcs;
+	unsigned char *saturatedArcs;
+	/* size and cut function of the optimal source set in the super graph,
+	cutConstant + cutMultiplier * lambda up to a term common to all source
+	sets (see evaluateCutFunction) */
+	uint sourceSetSize;
+	CutCoefficient cutConstant;
+	CutCoefficient cutMultiplier;
 } CutProblem;
 
 typedef struct Root
 {
-	Node *start;
-	Node *end;
+	uint start;
+	uint end;
 } Root;
 
+typedef struct ArenaBlock
+{
+	struct ArenaBlock *next;
+	size_t size;
+	size_t used;
+} ArenaBlock;
+
+typedef struct Arena
+{
+	ArenaBlock *first;
+	ArenaBlock *current;
+	size_t inUse;
+	size_t outside;
+	size_t highWater;
+	size_t limit;
+	/* the arena of root that the bytes in use of a worker or region block
+	arena count towards, and the lock of root. NULL for root. */
+	struct Arena *shared;
+	pthread_mutex_t *sharedLock;
+	/* the thread using the arena unwinds to unwind with error set when it
+	exceeds the limit or runs out of memory (see arenaRaise) */
+	jmp_buf *unwind;
+	int error;
+} Arena;
+
+typedef struct ArenaMark
+{
+	ArenaBlock *block;
+	size_t used;
+	size_t inUse;
+} ArenaMark;
+
+/* TrackedBlock - Header of a buffer of trackedMalloc. The buffers are
+linked in the root context, so an unwound solve frees the ones it still
+holds (see freeTracked). */
+typedef struct TrackedBlock
+{
+	struct TrackedBlock *prev;
+	struct TrackedBlock *next;
+} TrackedBlock;
+
+/* PoolBuffer - Header of a buffer of the problem buffer pool (see
+poolAlloc). The free buffers of a size class are linked through next. */
+typedef struct PoolBuffer
+{
+	struct PoolBuffer *next;
+	uint sizeClass;
+} PoolBuffer;
+
+/* Size classes of the problem buffer pool: four per doubling of
+POOL_MIN_BYTES, so a new buffer is at most a quarter larger than asked
+for (see poolClassBytes). A request takes a released buffer up to
+POOL_REUSE classes larger, a doubling for 4. */
+#define POOL_CLASSES 160
+#define POOL_MIN_BYTES 256
+#ifndef POOL_REUSE
+#define POOL_REUSE 4
+#endif
+
 typedef struct Breakpoint
 {
 	double lambdaValue;
 	//uint* sourceSetIndicator;
+	int placeholder;
 	struct Breakpoint *next;
 } Breakpoint;
 
+/* Open interval of the parametric cut between two solved problems. The
+source sets of the endpoints differ in freeNodes (NULL for all nodes), and
+the breakpoints found in the interval are inserted behind position, a
+placeholder in the breakpoint list. A deferred interval holds no source
+sets, low and high are NULL and the endpoints are solved again from their
+lambda values when the interval is taken from the queue. */
+/* The source sets of the parametric cut are nested. The problems at the
+endpoints of the intervals are the entries of a chain of source sets,
+ordered by lambda and, between entries at the same lambda, by order. Each
+node of the super graph records the entry at which it joins the source set,
+or the upper endpoint of the open interval in which it is free (see
+joinEntry), so a problem only keeps a source set indicator for its own free
+nodes, while its interval is processed. Entries are allocated in blocks of
+CHAIN_BLOCK << b entries that never move. */
+typedef struct ChainEntry
+{
+	Lambda lambdaValue;
+	double order;
+} ChainEntry;
+
+#define CHAIN_BLOCK 1024
+#define CHAIN_BLOCKS 32
+
+typedef struct Interval
+{
+	CutProblem *low;
+	CutProblem *high;
+	uint *freeNodes;
+	uint numFreeNodes;
+	Lambda lowLambda;
+	Lambda highLambda;
+	uint lowMaximal;
+	uint highMaximal;
+	uint lowEntry;
+	uint highEntry;
+	Breakpoint *position;
+} Interval;
+
+/* Lambda value solved before the parametric cut: the bounds of the lambda
+range and the seeds between them, with their minimal source sets. start
+and end are the wall-clock times of the solve. */
+typedef struct SeedPoint
+{
+	Lambda lambdaValue;
+	int saveArcs;
+	CutProblem *minimal;
+	double start;
+	double end;
+} SeedPoint;
+
+/* ArcPass - A parallel arc pass of initializeContractedProblem. Threads
+own a range of the free nodes, whose terminal capacities they reduce in
+the order of the super graph, and a range of the arcs, whose slots in the
+arc list of the problem they count and then write behind slotOffsets. */
+typedef struct ArcPass
+{
+	HpfContext *ctx;
+	CutProblem *problem;
+	const uint *arcIndices;
+	uint numArcsProblem;
+	uint numThreads;
+	uint *slotOffsets;
+	struct ArcPassThread *threads;
+	pthread_t *threadIds;
+} ArcPass;
+
+typedef struct ArcPassThread
+{
+	ArcPass *pass;
+	uint index;
+} ArcPassThread;
+
+/* RootBatch - Strong roots of the highest label, scanned for a weak node
+by the threads of a parallel pseudoflow run (see parallelPseudoflowPhase1).
+The scan of a root stops at the first arc to a weak node, recorded in
+arcs, strongNodes and weakNodes, or relabels the tree of the root and
+records NONE. Threads take the roots through nextRoot and meet at a
+barrier before and after each batch. */
+typedef struct RootBatch
+{
+	HpfContext *ctx;
+	uint *roots;
+	uint *arcs;
+	uint *strongNodes;
+	uint *weakNodes;
+	uint numRoots;
+	uint weakLabel;
+	uint nextRoot;
+	uint numThreads;
+	int done;
+	uint numWaiting;
+	uint generation;
+	pthread_mutex_t lock;
+	pthread_cond_t arrived;
+	struct RootBatchThread *threads;
+	pthread_t *threadIds;
+} RootBatch;
+
+typedef struct RootBatchThread
+{
+	RootBatch *batch;
+	uint numArcScans;
+	uint numRelabels;
+} RootBatchThread;
+
+/* Roots per thread of a batch of a parallel pseudoflow run, and the
+smallest batch that is scanned by all threads. Smaller batches are scanned
+by the calling thread alone, a barrier would cost more than the scan. */
+#ifndef ROOT_BATCH_SIZE
+#define ROOT_BATCH_SIZE 256
+#endif
+
+#ifndef ROOT_BATCH_MIN
+#define ROOT_BATCH_MIN 64
+#endif
+
+/* RegionBlock - A block of consecutive free nodes [first, last) of a
+problem, solved in a context of its own with the source, the sink and the
+arcs between them (see regionWarmStart) */
+typedef struct RegionBlock
+{
+	const CutProblem *problem;
+	HpfContext *blockCtx;
+	uint first;
+	uint last;
+	Node *nodeList;
+	NodeInfo *nodeInfo;
+	Capacity *sourceCapacity;
+	Capacity *sinkCapacity;
+	Arc *arcList;
+	// HPF_OK, or the error that unwound the solve of the block
+	int error;
+} RegionBlock;
+
+/* Minimum number of arcs per thread of a parallel arc pass. Smaller
+problems are copied by the calling thread alone, starting threads would
+cost more than the copy. */
+#ifndef ARC_PASS_CHUNK
+#define ARC_PASS_CHUNK 32768
+#endif
+
 #ifndef TRUE
 #define TRUE (1)
 #endif
@@ -188,91 +522,168 @@ typedef struct Breakpoint
 #endif
 
 /*************************************************************************
-Global variables
+Solver context
 *************************************************************************/
-// tolerance for denominator == 0
-static double TOL = 1E-7;
-static uint numNodes = 0;
-static uint numArcs = 0;
-static uint numNodesSuper = 0;
-static uint numArcsSuper = 0;
-static uint source;
-static uint sourceSuper;
-static uint sink;
-static uint sinkSuper;
-static uint highestStrongLabel = 1;
-
-static uint numBreakpoints = 0;
-static uint numArcScans = 0;
-static uint numPushes = 0;
-static uint numMergers = 0;
-static uint numRelabels = 0;
-static uint numGaps = 0;
-
-static Node *nodesList = NULL;
-static Root *strongRoots = NULL;
-static uint *labelCount = NULL;
-static Arc *arcList = NULL;
-static Node *nodeListSuper = NULL;
-static Arc *arcListSuper = NULL;
-static uint lowestPositiveExcessNode = 0;
-
-static double *nodeBreakpoints = NULL;
-
-static Breakpoint *lastBreakpoint = NULL;
-static Breakpoint *firstBreakpoint = NULL;
-
-static uint useParametricCut = 1;
-static uint roundNegativeCapacity = 0;
-
-static double LAMBDA_LOW;
-static double LAMBDA_HIGH;
-// static double oldLambdaIntersect = -1.0;
-
-// memory management
-static char * all_sink = NULL;
-static char * all_source = NULL;
-static int * nodeMap= NULL;
-static int * sourceAdjacentArcIndices= NULL;
-static int * sinkAdjacentArcIndices= NULL;
-
-static Arc *arcListCache[2]={NULL,NULL};
-static Node *nodeListCache[2]={NULL,NULL};;
-static Node *sourceSetCache[2]={NULL,NULL};;
-static Node *sinkSetCache[2]={NULL,NULL};;
-static char *pdifferenceCache = NULL;
-
-static time_t rawtime;
-static struct tm *info;
+#if defined(HPF_CAPACITY_FLOAT)
+// relative round-off of float excesses and residual capacities, about 50 float epsilons.
+// A larger tolerance takes nodes near a breakpoint as indifferent and adds breakpoints.
+static const double RESIDUAL_TOL = 3E-6;
+#elif !defined(HPF_INTEGER_CAPACITY)
+// relative round-off of double excesses and residual capacities
+static const double RESIDUAL_TOL = 1E-9;
+#endif
 
 
-double dabs(double value)
+struct HpfContext
+{
+	uint numNodes;
+	uint numArcs;
+	uint numNodesSuper;
+	uint numArcsSuper;
+	uint source;
+	uint sourceSuper;
+	uint sink;
+	uint sinkSuper;
+	uint highestStrongLabel;
+
+	uint numBreakpoints;
+	uint numArcScans;
+	uint numPushes;
+	uint numMergers;
+	uint numRelabels;
+	uint numGaps;
+
+	Node *nodesList;
+	NodeInfo *nodeInfo;
+	Capacity *sourceCapacity;
+	Capacity *sinkCapacity;
+	uint *labels;
+	uint *outOfTreeOffsets;
+	uint *outOfTreeArcs;
+	Root *strongRoots;
+	uint *labelCount;
+	Arc *arcList;
+	NodeInfo *nodeListSuper;
+	Arc *arcListSuper;
+	uint *superIncidenceOffsets;
+	uint *superIncidentArcs;
+	uint lowestPositiveExcessNode;
+
+	double *nodeBreakpoints;
+
+	Breakpoint *lastBreakpoint;
+	Breakpoint *firstBreakpoint;
+
+	uint useParametricCut;
+	uint roundNegativeCapacity;
+	uint warmStart;
+	uint freeRuns;
+	unsigned char *warmStartArcs;
+
+	// queue of open intervals, a ring buffer used as a stack or a queue
+	Interval *intervals;
+	uint intervalsSize;
+	uint intervalsHead;
+	uint numIntervals;
+	uint numMaterializedIntervals;
+	uint maxQueueDepth;
+	uint breadthFirst;
+	uint openIntervalCap;
+
+	Lambda LAMBDA_LOW;
+	Lambda LAMBDA_HIGH;
+
+	// chain of source sets (see ChainEntry), used through root
+	uint *joinEntries;
+	ChainEntry *chainBlocks[CHAIN_BLOCKS];
+	uint numChainEntries;
+	uint topEntry;
+
+	// memory management
+	int *nodeMap;
+
+	// node and arc buffers of the contracted problems, by size class
+	PoolBuffer *pool[POOL_CLASSES];
+
+	// per-solve scratch memory and source set indicators
+	Arena arena;
+	// buffers of trackedMalloc, used through root
+	TrackedBlock *tracked;
+
+	/* parallel parametric cut: workers are contexts with their own solve
+	state, arena and caches. They share the super graph with root, and the
+	interval queue, the breakpoints and the source sets of root under its
+	lock. root is the context itself outside of the workers. */
+	HpfContext *root;
+	uint numThreads;
+	uint numWorkers;
+	uint numBusyWorkers;
+	// error that unwound a worker, the others stop at their next interval or point
+	int error;
+	double endpointOverlap;
+	/* threads of a worker that no other worker runs on, for its arc passes
+	and pseudoflow runs. root uses numThreads. */
+	uint spareThreads;
+	// subproblems with at least this many nodes use the parallel pseudoflow, 0 for none
+	uint parallelPseudoflowNodes;
+	// problems with at least this many nodes start from the flows of their blocks, 0 for none
+	uint regionNodes;
+	/* the arcs between nodes other than the source and sink are undirected
+	edges, stored once (see isEdge and createMemoryStructures) */
+	uint undirected;
+
+	// seeds of the parametric cut and the points solved before it
+	uint numSeeds;
+	uint seedFromRatios;
+	SeedPoint *points;
+	uint numPoints;
+	uint nextPoint;
+	pthread_mutex_t lock;
+	pthread_cond_t workChanged;
+};
+
+
+static __inline double dabs(double value)
 {
 	if (value >= 0)
 		return value;
 	else return -value;
 }
 
-double math_min(double x, double y)
+static __inline double math_min(double x, double y)
 {
 	if (x >= y)
 		return y;
 	else return x;
 }
 
-double math_max(double x, double y)
+static __inline double math_max(double x, double y)
 {
 	if (x >= y)
 		return x;
 	else return y;
 }
 
+static double wallClock(void)
+/*************************************************************************
+wallClock - Seconds on a monotonic clock. The solve times are wall-clock
+times, the processor time of a process adds up all of its threads.
+*************************************************************************/
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+#ifdef HPF_DOUBLE_CAPACITY
 void libfree(void* p)
 {
 	free(p);
 }
+#endif
 
-int isFlow(double flow)
+static __inline int isFlow(Capacity flow)
 /*************************************************************************
 isFlow: We set a threshhold. If the flow value is below the threshhold, we
 take it as no flow. Otherwise we take it as a flow
@@ -283,7 +694,7 @@ take it as no flow. Otherwise we take it as a flow
 	else return 0;
 }
 
-int isExcess(double excess)
+static __inline int isExcess(Capacity excess)
 /*************************************************************************
 isExcess: We set a threshhold. If the absolute value of the excess is within
 the threshold, then we take it as nothing. Otherwise we will return the sign
@@ -297,1023 +708,1993 @@ of the excess (deficit if negative).
 	else return 0;
 }
 
-
-static void createOutOfTree (Node *nd)
+#ifdef HPF_INTEGER_CAPACITY
+static llint gcd(llint a, llint b)
 {
-/*************************************************************************
-createOutOfTree
-*************************************************************************/
-	if (nd->numAdjacent)
+	llint t;
+
+	if (a < 0) a = -a;
+	if (b < 0) b = -b;
+	while (b)
 	{
-		if ((nd->outOfTree = (Arc **) malloc (nd->numAdjacent * sizeof (Arc *))) == NULL)
-		{
-			printf("Out of memory\n");
-			exit(0);
-		}
+		t = a % b;
+		a = b;
+		b = t;
 	}
+	return a;
 }
 
-
-static void initializeArc (Arc *ac)
-{
+static Lambda makeLambda(llint num, llint den)
 /*************************************************************************
-initializeArc
+makeLambda - Reduced fraction with a positive denominator
 *************************************************************************/
-	ac->from = NULL;
-	ac->to = NULL;
-	ac->capacity = 0.0;
-	ac->flow = 0.0;
-	ac->direction = 1;
-	ac->constant = 0.0;
-	ac->multiplier = 0.0;
+{
+	Lambda lambda;
+	llint divisor;
+
+	if (den < 0)
+	{
+		num = -num;
+		den = -den;
+	}
+	divisor = gcd(num, den);
+	if (divisor > 1)
+	{
+		num /= divisor;
+		den /= divisor;
+	}
+	lambda.num = num;
+	lambda.den = den;
+	return lambda;
 }
 
-static void liftAll (Node *rootNode)
-{
+static Lambda lambdaFromDouble(double value)
 /*************************************************************************
-liftAll
+lambdaFromDouble - Exact fraction for a dyadic value. Other values are
+rounded to a denominator of 2^30.
 *************************************************************************/
-	Node *temp, *current=rootNode;
-
-	current->nextScan = current->childList;
-
-	-- labelCount[current->label];
-	current->label = numNodes;
+{
+	llint den = 1;
 
-	for ( ; (current); current = current->parent)
+	while ((double) (llint) (value * den) != value * den && den < (1LL << 30))
 	{
-		while (current->nextScan)
-		{
-			temp = current->nextScan;
-			current->nextScan = current->nextScan->next;
-			current = temp;
-			current->nextScan = current->childList;
-
-			-- labelCount[current->label];
-			current->label = numNodes;
-		}
+		den <<= 1;
 	}
+	return makeLambda((llint) (value * den + (value < 0 ? -0.5 : 0.5)), den);
 }
-static void addOutOfTreeNode (Node *n, Arc *out)
+
+static __inline double lambdaToDouble(Lambda lambda)
 {
-/*************************************************************************
-addOutOfTreeNode
-*************************************************************************/
-	n->outOfTree[n->numOutOfTree] = out;
-	++ n->numOutOfTree;
+	return (double) lambda.num / lambda.den;
 }
 
-static uint sum_array_uint(uint *array, uint num_elements)
+static __inline double lambdaScale(Lambda lambda)
 {
-    uint sum = 0;
-    for (uint i = 0; i< num_elements; i++)
-    {
-        sum += array[i];
-    }
-    return sum;
+	return (double) lambda.den;
 }
 
-
-static uint sum_array_char(char *array, uint num_elements)
+static __inline int lambdaCompare(Lambda x, Lambda y)
 {
-    uint sum = 0;
-		// printf("Number of elements is %d\n", num_elements);
-    for (uint i = 0; i< num_elements; i++)
-    {
-				// printf("array %d is %c\n", i, array[i]); fflush;
-        sum += array[i];
-    }
-    return sum;
+	double lhs = (double) x.num * y.den;
+	double rhs = (double) y.num * x.den;
+
+	if (lhs < rhs)
+		return -1;
+	else if (lhs > rhs)
+		return 1;
+	else if (x.num * y.den < y.num * x.den)
+		return -1;
+	else if (x.num * y.den > y.num * x.den)
+		return 1;
+	else return 0;
 }
 
-static void addToStrongBucket (Node *newRoot, Root *rootBucket)
-{
+static Lambda lambdaBetween(Lambda low, Lambda high, uint part, uint numParts)
 /*************************************************************************
-addToStrongBucket
+lambdaBetween - low + (high - low) * part / numParts as an exact fraction
 *************************************************************************/
-	if (rootBucket->start)
-	{
-		rootBucket->end->next = newRoot;
-		rootBucket->end = newRoot;
-		newRoot->next = NULL;
-	}
-	else
-	{
-		rootBucket->start = newRoot;
-		rootBucket->end = newRoot;
-		newRoot->next = NULL;
-	}
+{
+	return makeLambda(low.num * high.den * numParts + (high.num * low.den - low.num * high.den) * part,
+		low.den * high.den * numParts);
 }
 
-static __inline int addRelationship (Node *newParent, Node *child)
-{
+static Lambda lambdaRatio(Capacity num, Capacity den)
 /*************************************************************************
-addRelationship
+lambdaRatio - num / den for a positive den
 *************************************************************************/
-	child->parent = newParent;
-	child->next = newParent->childList;
-
-#ifdef PREV_CHILDLIST
-    if (newParent->childList != NULL)
-    {
-        newParent->childList->prev = child;
-    }
-#endif
-
-	newParent->childList = child;
-	return 0;
+{
+	return makeLambda((llint) num, (llint) den);
 }
 
-static __inline void breakRelationship (Node *oldParent, Node *child)
-{
+static Capacity scaledCapacity(const HpfContext *ctx, Capacity constant, Capacity multiplier, Lambda lambda)
 /*************************************************************************
-breakRelationship
+scaledCapacity - den * (multiplier * lambda + constant). An overflow sets
+the error of the root context to HPF_ERROR_INVALID_INPUT and gives 0: the
+helper threads of an arc pass have no unwind point, so the error stops the
+solve at the next interval, and the solve returns it.
 *************************************************************************/
-	Node *current;
-
-	child->parent = NULL;
-
-	if (oldParent->childList == child)
+{
+	if (dabs((double) multiplier * lambda.num) + dabs((double) constant * lambda.den) > CAPACITY_LIMIT)
 	{
-		oldParent->childList = child->next;
-		child->next = NULL;
-		return;
+		__atomic_store_n(&ctx->root->error, HPF_ERROR_INVALID_INPUT, __ATOMIC_RELAXED);
+		return 0;
 	}
-#ifdef PREV_CHILDLIST
-    current = child->prev;
-    if (child->next != NULL) child->next->prev = current;
+	return (Capacity) (multiplier * lambda.num + constant * lambda.den);
+}
 
+static int isIntegerCapacity(double value)
+{
+	return dabs(value) <= CAPACITY_LIMIT && (double) (Capacity) value == value;
+}
 #else
-	for (current = oldParent->childList; (current->next != child); current = current->next);
-#endif
-	current->next = child->next;
-	child->next = NULL;
+static __inline Lambda lambdaFromDouble(double value)
+{
+	return value;
 }
 
-static void merge (Node *parent, Node *child, Arc *newArc)
+static __inline double lambdaToDouble(Lambda lambda)
 {
-/*************************************************************************
-merge
-*************************************************************************/
-	Arc *oldArc;
-	Node *current = child, *oldParent, *newParent = parent;
+	return lambda;
+}
 
-	++ numMergers;
+static __inline double lambdaScale(Lambda lambda)
+{
+	return 1.0;
+}
 
-	while (current->parent)
-	{
-		oldArc = current->arcToParent;
-		current->arcToParent = newArc;
-		oldParent = current->parent;
-		breakRelationship (oldParent, current);
-		addRelationship (newParent, current);
-		newParent = current;
-		current = oldParent;
-		newArc = oldArc;
-		newArc->direction = 1 - newArc->direction;
-	}
+static __inline Lambda lambdaBetween(Lambda low, Lambda high, uint part, uint numParts)
+{
+	return low + (high - low) * part / numParts;
+}
 
-	current->arcToParent = newArc;
-	addRelationship (newParent, current);
+static __inline Lambda lambdaRatio(Capacity num, Capacity den)
+{
+	return (Lambda) num / den;
 }
 
+static __inline int lambdaCompare(Lambda x, Lambda y)
+{
+	return (x > y) - (x < y);
+}
 
-static __inline void pushUpward (Arc *currentArc, Node *child, Node *parent, const double resCap)
+static __inline Capacity scaledCapacity(const HpfContext *ctx, Capacity constant, Capacity multiplier, Lambda lambda)
 {
-/*************************************************************************
-pushUpward
-*************************************************************************/
-	++ numPushes;
+	return multiplier * lambda + constant;
+}
+#endif
 
-	if (isExcess(resCap-child->excess) >= 0)//(/*(int)*/resCap >= child->excess)
-	{
-		parent->excess += child->excess;
-		currentArc->flow += child->excess;
-		child->excess = 0;
-		return;
-	}
 
-	currentArc->direction = 0;
-	parent->excess += resCap;
-	child->excess -= resCap;
-	currentArc->flow = currentArc->capacity;
-	parent->outOfTree[parent->numOutOfTree] = currentArc;
-	++ parent->numOutOfTree;
-	breakRelationship (parent, child);
+#define ARENA_ALIGNMENT 16
 
-	addToStrongBucket (child, &strongRoots[child->label]);
+static void arenaRaise (Arena *arena, int error)
+{
+/*************************************************************************
+arenaRaise - Unwind the thread using the arena to the solve, worker or
+block that set its unwind point, with error
+*************************************************************************/
+	assert(arena->unwind != NULL);
+	arena->error = error;
+	longjmp(*arena->unwind, 1);
 }
 
-
-static __inline void pushDownward (Arc *currentArc, Node *child, Node *parent, double flow)
+static void arenaCharge (Arena *arena, size_t bytes)
 {
 /*************************************************************************
-pushDownward
+arenaCharge - Count bytes taken from a worker or region block arena
+towards the limit and high-water mark of the shared arena, so they cover
+the memory in use by all threads at the same time
 *************************************************************************/
-	++ numPushes;
+	Arena *shared = arena->shared;
 
-	if (isExcess(flow - child->excess) >= 0)//(/*(int)*/flow >= child->excess)
+	pthread_mutex_lock(arena->sharedLock);
+	if (shared->limit && shared->inUse + shared->outside + bytes > shared->limit)
 	{
-		parent->excess += child->excess;
-		currentArc->flow -= child->excess;
-		child->excess = 0;
-		return;
+		pthread_mutex_unlock(arena->sharedLock);
+		arenaRaise(arena, HPF_ERROR_ARENA_LIMIT);
 	}
 
-	currentArc->direction = 1;
-	child->excess -= flow;
-	parent->excess += flow;
-	currentArc->flow = 0;
-	parent->outOfTree[parent->numOutOfTree] = currentArc;
-	++ parent->numOutOfTree;
-	breakRelationship (parent, child);
-
-	addToStrongBucket (child, &strongRoots[child->label]);
+	shared->outside += bytes;
+	if (shared->inUse + shared->outside > shared->highWater)
+	{
+		shared->highWater = shared->inUse + shared->outside;
+	}
+	pthread_mutex_unlock(arena->sharedLock);
 }
 
-static void printCutProblem(CutProblem *p){
-    // printf("numNodes: %u\n " ,p->numNodesInList);
-    // printf("numSource %u\n" ,p->numSourceSet);
-    // printf("numSink: %u\n" ,p->numSinkSet);
-    // printf("numArcs: %u\n" ,p->numArcs);
-    printf("c solved: %u\n" ,p->solved);
-    printf("c lambda:%.12lf\n" ,p->lambdaValue);
-    int i;
-    // printf("[from, to](capacity,constant,multiplier)\n");
-    // for(i=0;i<p->numArcs;++i)
-    // {
-    //     printf("[%d,%d](%.12lf,%.12lf,%.12lf)\n",p->arcList[i].from->originalIndex,p->arcList[i].to->originalIndex,p->arcList[i].capacity,p->arcList[i].constant,p->arcList[i].multiplier);
-    // }
-    // printf("\n");
-    //printArcListInfo(arcList);
-    //printNodeListInfo(nodeList);
-    printf("c Cut value is %.12lf\n" ,p->cutValue);
-    // printNodeListInfo(sourceSet);
-    // printSinkListInfo(sinkSet);
-    if (p->solved == 1)
-    {
-				int sourcenodes = 0;
-        for(i=0;i<numNodesSuper;++i)
-        {
-					sourcenodes += p->optimalSourceSetIndicator[i];
-          printf("%u ",p->optimalSourceSetIndicator[i]);
-        }
-				printf("\n");
-				printf("Nodes in source set: %d\n", sourcenodes);
-    }
-    // printf("SourceSuper: %d, SinkSuper: %d\n", sourceSuper, sinkSuper);
-    printf("\n");
-    printf("\n");
+static void arenaUncharge (Arena *arena, size_t bytes)
+{
+/*************************************************************************
+arenaUncharge - Return bytes counted by arenaCharge
+*************************************************************************/
+	pthread_mutex_lock(arena->sharedLock);
+	arena->shared->outside -= bytes;
+	pthread_mutex_unlock(arena->sharedLock);
 }
 
-static void pushExcess (Node *strongRoot)
+static void * arenaAlloc (Arena *arena, size_t bytes)
 {
 /*************************************************************************
-pushExcess
+arenaAlloc - Bump allocate bytes from the arena. Blocks that were released
+earlier are reused before a new block is requested from malloc.
 *************************************************************************/
-	Node *current, *parent;
-	Arc *arcToParent;
-	/*int*/double prevEx=1;
+	ArenaBlock *block = arena->current;
+	ArenaBlock *newBlock;
+	size_t blockSize;
+	void *p;
+
+	bytes = (bytes + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+	if (arena->shared != NULL)
+	{
+		arenaCharge(arena, bytes);
+	}
+	else if (arena->limit && arena->inUse + arena->outside + bytes > arena->limit)
+	{
+		arenaRaise(arena, HPF_ERROR_ARENA_LIMIT);
+	}
 
-	for (current = strongRoot; (isExcess(current->excess) && current->parent); current = parent)
+	while (block && block->used + bytes > block->size)
 	{
-		parent = current->parent;
-		prevEx = parent->excess;
+		block = block->next;
+		if (block)
+		{
+			block->used = 0;
+		}
+	}
 
-		arcToParent = current->arcToParent;
+	if (block == NULL)
+	{
+		blockSize = (arena->current && arena->current->size > bytes) ? arena->current->size : bytes;
+		if ((newBlock = (ArenaBlock *)malloc(sizeof(ArenaBlock) + ARENA_ALIGNMENT + blockSize)) == NULL)
+		{
+			if (arena->shared != NULL)
+			{
+				arenaUncharge(arena, bytes);
+			}
+			arenaRaise(arena, HPF_ERROR_OUT_OF_MEMORY);
+		}
+		newBlock->size = blockSize;
+		newBlock->used = 0;
 
-		if (arcToParent->direction)
+		/* keep blocks ordered by use: insert behind the current block */
+		if (arena->current)
 		{
-			pushUpward (arcToParent, current, parent, (arcToParent->capacity - arcToParent->flow));
+			newBlock->next = arena->current->next;
+			arena->current->next = newBlock;
 		}
 		else
 		{
-			pushDownward (arcToParent, current, parent, arcToParent->flow);
+			newBlock->next = arena->first;
+			arena->first = newBlock;
 		}
+		block = newBlock;
 	}
 
-	if ((isExcess(current->excess) > 0) && (isExcess(prevEx) <= 0))
+	p = (char *)block + ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1)) + block->used;
+	block->used += bytes;
+	arena->current = block;
+
+	arena->inUse += bytes;
+	if (arena->inUse + arena->outside > arena->highWater)
 	{
-		addToStrongBucket (current, &strongRoots[current->label]);
+		arena->highWater = arena->inUse + arena->outside;
 	}
-}
 
+	return p;
+}
 
-static Arc * findWeakNode (Node *strongNode, Node **weakNode)
+static ArenaMark arenaMark (const Arena *arena)
 {
 /*************************************************************************
-findWeakNode
+arenaMark
 *************************************************************************/
-	uint i, size;
-	Arc *out;
+	ArenaMark mark;
 
-	size = strongNode->numOutOfTree;
+	mark.block = arena->current;
+	mark.used = arena->current ? arena->current->used : 0;
+	mark.inUse = arena->inUse;
+	return mark;
+}
+
+static void arenaRelease (Arena *arena, ArenaMark mark)
+{
+/*************************************************************************
+arenaRelease - Return everything allocated after mark in O(1)
+*************************************************************************/
+	if (arena->shared != NULL)
+	{
+		arenaUncharge(arena, arena->inUse - mark.inUse);
+	}
 
-	for (i=strongNode->nextArc; i<size; ++i)
+	if (mark.block)
+	{
+		mark.block->used = mark.used;
+		arena->current = mark.block;
+	}
+	else
 	{
-		++ numArcScans;
-		if (strongNode->outOfTree[i]->to->label == (highestStrongLabel-1))
+		arena->current = NULL;
+		if (arena->first)
 		{
-			strongNode->nextArc = i;
-			out = strongNode->outOfTree[i];
-			(*weakNode) = out->to;
-			-- strongNode->numOutOfTree;
-			strongNode->outOfTree[i] = strongNode->outOfTree[strongNode->numOutOfTree];
-			return (out);
-		} else if (strongNode->outOfTree[i]->from->label == (highestStrongLabel-1)) {
-			strongNode->nextArc = i;
-			out = strongNode->outOfTree[i];
-			(*weakNode) = out->from;
-			-- strongNode->numOutOfTree;
-			strongNode->outOfTree[i] = strongNode->outOfTree[strongNode->numOutOfTree];
-			return (out);
+			arena->first->used = 0;
+			arena->current = arena->first;
 		}
 	}
-
-	strongNode->nextArc = strongNode->numOutOfTree;
-
-	return NULL;
+	arena->inUse = mark.inUse;
 }
 
-
-static void checkChildren (Node *curNode)
+static void arenaReserve (Arena *arena, size_t bytes)
 {
 /*************************************************************************
-checkChildren
+arenaReserve - Make sure the first block holds at least bytes
 *************************************************************************/
-	for ( ; (curNode->nextScan); curNode->nextScan = curNode->nextScan->next)
+	ArenaMark start = arenaMark(arena);
+	size_t highWater = arena->highWater;
+
+	if (arena->first == NULL)
 	{
-		if (curNode->nextScan->label == curNode->label)
-		{
-			return;
-		}
+		arenaAlloc(arena, bytes);
+		arenaRelease(arena, start);
+		arena->highWater = highWater;
+	}
+}
+
+static void arenaFree (Arena *arena)
+{
+/*************************************************************************
+arenaFree
+*************************************************************************/
+	ArenaBlock *block = arena->first;
+	ArenaBlock *next;
+
+	if (arena->shared != NULL)
+	{
+		arenaUncharge(arena, arena->inUse);
+	}
 
+	while (block)
+	{
+		next = block->next;
+		free(block);
+		block = next;
 	}
 
-	-- labelCount[curNode->label];
-	++	curNode->label;
-	++ labelCount[curNode->label];
+	arena->first = NULL;
+	arena->current = NULL;
+	arena->inUse = 0;
+}
+
+static __inline void lockShared (HpfContext *ctx)
+/*************************************************************************
+lockShared - Lock the state shared by the workers, while there are any
+*************************************************************************/
+{
+	if (ctx->root->numWorkers > 0)
+	{
+		pthread_mutex_lock(&ctx->root->lock);
+	}
+}
 
-	++numRelabels;
+static __inline void unlockShared (HpfContext *ctx)
+/*************************************************************************
+unlockShared
+*************************************************************************/
+{
+	if (ctx->root->numWorkers > 0)
+	{
+		pthread_mutex_unlock(&ctx->root->lock);
+	}
+}
 
-	curNode->nextArc = 0;
+static __inline uint contextThreads (const HpfContext *ctx)
+/*************************************************************************
+contextThreads - Threads a context may use for a single problem: all of
+them for root, the spare threads for a worker
+*************************************************************************/
+{
+	return ctx == ctx->root ? ctx->numThreads : ctx->spareThreads;
 }
 
+/* buffers of trackedMalloc start behind their header, aligned like the arena */
+#define TRACKED_HEADER ARENA_ALIGNMENT
 
-static void simpleInitialization (void)
+static void * trackedMalloc (HpfContext *ctx, size_t bytes)
 {
 /*************************************************************************
-simpleInitialization
+trackedMalloc - Allocate memory that does not follow the last in, first
+out order of the arena, counted against the limit and high-water mark of
+the arena of the root context
 *************************************************************************/
-	uint i, size;
-	Arc *tempArc;
+	HpfContext *root = ctx->root;
+	Arena *arena = &root->arena;
+	TrackedBlock *block;
 
-	size = nodesList[source].numOutOfTree;
-	for (i=0; i<size; ++i) // Saturating source adjacent nodes
+	if ((block = (TrackedBlock *)malloc(TRACKED_HEADER + bytes)) == NULL)
 	{
-		tempArc = nodesList[source].outOfTree[i];
-		tempArc->flow = tempArc->capacity;
-		tempArc->to->excess += tempArc->capacity;
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
 	}
 
-	size = nodesList[sink].numOutOfTree;
-	for (i=0; i<size; ++i) // Pushing maximum flow on sink adjacent nodes
+	lockShared(ctx);
+	if (arena->limit && arena->inUse + arena->outside + bytes > arena->limit)
 	{
-		tempArc = nodesList[sink].outOfTree[i];
-		tempArc->flow = tempArc->capacity;
-		tempArc->from->excess -= tempArc->capacity;
+		unlockShared(ctx);
+		free(block);
+		arenaRaise(&ctx->arena, HPF_ERROR_ARENA_LIMIT);
 	}
 
-	nodesList[source].excess = 0; // zeroing source excess
-	nodesList[sink].excess = 0;	// zeroing sink excess
+	arena->outside += bytes;
+	if (arena->inUse + arena->outside > arena->highWater)
+	{
+		arena->highWater = arena->inUse + arena->outside;
+	}
 
-	for (i=0; i<numNodes; ++i)
+	block->prev = NULL;
+	block->next = root->tracked;
+	if (block->next != NULL)
 	{
-		if (isExcess(nodesList[i].excess) > 0)
-		{
-		    nodesList[i].label = 1;
-			++ labelCount[1];
+		block->next->prev = block;
+	}
+	root->tracked = block;
+	unlockShared(ctx);
+
+	return (char *) block + TRACKED_HEADER;
+}
+
+static void trackedFree (HpfContext *ctx, void *p, size_t bytes)
+{
+/*************************************************************************
+trackedFree - Free memory from trackedMalloc
+*************************************************************************/
+	TrackedBlock *block;
 
-			addToStrongBucket (&nodesList[i], &strongRoots[1]);
+	if (p != NULL)
+	{
+		block = (TrackedBlock *)((char *) p - TRACKED_HEADER);
+		lockShared(ctx);
+		if (block->prev != NULL)
+		{
+			block->prev->next = block->next;
+		}
+		else
+		{
+			ctx->root->tracked = block->next;
+		}
+		if (block->next != NULL)
+		{
+			block->next->prev = block->prev;
 		}
+		ctx->root->arena.outside -= bytes;
+		unlockShared(ctx);
+		free(block);
 	}
+}
+
+static void freeTracked (HpfContext *ctx)
+{
+/*************************************************************************
+freeTracked - Free the memory from trackedMalloc that an unwound solve
+still held
+*************************************************************************/
+	TrackedBlock *block;
 
-	nodesList[source].label = numNodes;	// Set the source label to n
-	nodesList[sink].label = 0;			// set the sink label to 0
-	labelCount[0] = (numNodes - 2) - labelCount[1];
+	while ((block = ctx->tracked) != NULL)
+	{
+		ctx->tracked = block->next;
+		free(block);
+	}
+	ctx->arena.outside = 0;
 }
 
+/* buffers of the pool start behind their header, aligned like the arena */
+#define POOL_HEADER ARENA_ALIGNMENT
 
-static Node* getHighestStrongRoot (void)
+static __inline size_t poolClassBytes (uint sizeClass)
+{
+	return ((size_t) POOL_MIN_BYTES << (sizeClass / 4)) / 4 * (4 + sizeClass % 4);
+}
+
+static void freePool (HpfContext *ctx)
 {
 /*************************************************************************
-getHighestStrongRoot
+freePool - Free the released buffers of all size classes
 *************************************************************************/
 	uint i;
-	Node *strongRoot;
+	PoolBuffer *buffer;
 
-	for (i=highestStrongLabel; i>0; --i)
+	for (i = 0; i < POOL_CLASSES; ++i)
 	{
-		if (strongRoots[i].start)
+		while ((buffer = ctx->pool[i]) != NULL)
 		{
-			highestStrongLabel = i;
-			if (labelCount[i-1])
-			{
-				strongRoot = strongRoots[i].start;
-				strongRoots[i].start = strongRoot->next;
-				strongRoot->next = NULL;
-				return strongRoot;
-			}
-
-			while (strongRoots[i].start)
-			{
-				++ numGaps;
-
-				strongRoot = strongRoots[i].start;
-				strongRoots[i].start = strongRoot->next;
-				liftAll (strongRoot);
-			}
+			ctx->pool[i] = buffer->next;
+			trackedFree(ctx, buffer, POOL_HEADER + poolClassBytes(i));
 		}
 	}
+}
+
+static void * poolAlloc (HpfContext *ctx, size_t bytes)
+{
+/*************************************************************************
+poolAlloc - Buffer of at least bytes for the graph of a problem. A
+released buffer of the smallest size class that fits, or of one of the
+next POOL_REUSE classes, is reused. Otherwise the released buffers are
+freed before a new one is allocated, so the pool never holds more than
+the peak of the buffers in use.
+*************************************************************************/
+	uint sizeClass = 0;
+	uint i;
+	PoolBuffer *buffer;
 
-	if (!strongRoots[0].start)
+	while (sizeClass + 1 < POOL_CLASSES && poolClassBytes(sizeClass) < bytes)
 	{
-		return NULL;
+		++sizeClass;
 	}
 
-	while (strongRoots[0].start)
+	for (i = sizeClass; i < POOL_CLASSES && i <= sizeClass + POOL_REUSE; ++i)
 	{
-		strongRoot = strongRoots[0].start;
-		strongRoots[0].start = strongRoot->next;
-		strongRoot->label = 1;
-		-- labelCount[0];
-		++ labelCount[1];
-
-		++ numRelabels;
-
-		addToStrongBucket (strongRoot, &strongRoots[strongRoot->label]);
+		if ((buffer = ctx->pool[i]) != NULL)
+		{
+			ctx->pool[i] = buffer->next;
+			return (char *) buffer + POOL_HEADER;
+		}
 	}
 
-	highestStrongLabel = 1;
-
-	strongRoot = strongRoots[1].start;
-	strongRoots[1].start = strongRoot->next;
-	strongRoot->next = NULL;
-
-	return strongRoot;
+	freePool(ctx);
+	buffer = (PoolBuffer *)trackedMalloc(ctx, POOL_HEADER + poolClassBytes(sizeClass));
+	buffer->sizeClass = sizeClass;
+	return (char *) buffer + POOL_HEADER;
 }
 
+static void poolRelease (HpfContext *ctx, void *p)
+{
+/*************************************************************************
+poolRelease - Return a buffer of poolAlloc to its size class
+*************************************************************************/
+	PoolBuffer *buffer;
 
+	if (p == NULL)
+	{
+		return;
+	}
 
-static void initializeRoot (Root *rt)
+	buffer = (PoolBuffer *) ((char *) p - POOL_HEADER);
+	buffer->next = ctx->pool[buffer->sizeClass];
+	ctx->pool[buffer->sizeClass] = buffer;
+}
+
+static __inline uint * outOfTreeArcs (HpfContext *ctx, const uint node)
 {
 /*************************************************************************
-initializeRoot
+outOfTreeArcs - Slice of the out-of-tree arc index array owned by node.
+The slice has room for all numAdjacent incident arcs of the node.
 *************************************************************************/
-	rt->start = NULL;
-	rt->end = NULL;
+	return &ctx->outOfTreeArcs[ctx->outOfTreeOffsets[node]];
 }
 
 
-static void initializeNode (Node *nd, const uint n)
+static void initializeArc (Arc *ac)
 {
 /*************************************************************************
-initializeNode
+initializeArc
 *************************************************************************/
-	nd->label = 0;
-	nd->excess = 0.0;
-	nd->parent = NULL;
-	nd->childList = NULL;
-	nd->nextScan = NULL;
-	nd->nextArc = 0;
-	nd->numOutOfTree = 0;
-	nd->arcToParent = NULL;
-	nd->next = NULL;
-	nd->prev= NULL;
-	nd->visited = 0;
-	nd->numAdjacent = 0;
-	nd->number = n;
-	nd->originalIndex = -10;
-	nd->outOfTree = NULL;
+	ac->from = NONE;
+	ac->to = NONE;
+	ac->capacity = 0.0;
+	ac->flow = 0.0;
+	ac->direction = 1;
+	ac->constant = 0.0;
+	ac->multiplier = 0.0;
+	ac->superArc = NONE;
 }
 
-static void destroyBreakpoint(Breakpoint *currentBreakpoint)
+static __inline int isEdge (const HpfContext *ctx, const Arc *superArc)
+{
 /*************************************************************************
-destroyBreakpoint - Removes breakpoint and subsequent ones
+isEdge - Whether an arc of the super graph is an undirected edge: in the
+edge mode, every arc between nodes other than the source and sink
 *************************************************************************/
-{
-	if (currentBreakpoint != NULL)
-	{
-        /* free sourceset indicator */
-    	//free(currentBreakpoint->sourceSetIndicator);
-    	//currentBreakpoint->sourceSetIndicator = NULL;
+	return ctx->undirected
+		&& superArc->from != ctx->sourceSuper && superArc->from != ctx->sinkSuper
+		&& superArc->to != ctx->sourceSuper && superArc->to != ctx->sinkSuper;
+}
 
-    	/* iterate through breakpoint list */
-    	destroyBreakpoint(currentBreakpoint->next);
-    	currentBreakpoint->next = NULL;
+static __inline void orientEdge (const HpfContext *ctx, const Arc *superArc, uint *from, uint *to)
+{
+/*************************************************************************
+orientEdge - Turn the contracted indices of an edge with one end in the
+source (0) or the sink (1) so that it leaves the source or enters the
+sink: the edge is a source arc or a sink arc of its other end
+*************************************************************************/
+	uint swap;
 
-    	/* free breakpoint */
-    	free(currentBreakpoint);
-    	currentBreakpoint = NULL;
+	if ((*to == 0 || *from == 1) && isEdge(ctx, superArc))
+	{
+		swap = *from;
+		*from = *to;
+		*to = swap;
 	}
-
 }
 
-static void freeRoot (Root *rt)
+static __inline Capacity edgeCapacity (const HpfContext *ctx, const Arc *arc)
 {
 /*************************************************************************
-freeRoot
+edgeCapacity - Capacity of an arc of a problem in each of its directions:
+an edge of weight c is solved as an arc of capacity 2c
 *************************************************************************/
-	rt->start = NULL;
-	rt->end = NULL;
+	return ctx->undirected ? arc->capacity / 2 : arc->capacity;
 }
 
-static void freeCaches(void)
+static __inline int isArcSaturated (const unsigned char *arcBits, const uint superArc)
 {
-
-    if(all_sink!=NULL) free(all_sink);
-    if(all_source!=NULL) free(all_source);
-    if(nodeMap!=NULL) free(nodeMap);
-    if(sourceAdjacentArcIndices!=NULL) free(sourceAdjacentArcIndices);
-    if(sinkAdjacentArcIndices!=NULL) free(sinkAdjacentArcIndices);
-    if(pdifferenceCache!=NULL) free(pdifferenceCache);
-
-    for(int i=0; i<2; i++)
-    {
-        if(arcListCache[i]!=NULL) free(arcListCache[i]);
-        if(nodeListCache[i]!=NULL) free(nodeListCache[i]);
-        if(sourceSetCache[i]!=NULL) free(sourceSetCache[i]);
-        if(sinkSetCache[i]!=NULL) free(sinkSetCache[i]);
-    }
-
-    all_sink = NULL;
-    all_source = NULL;
-    nodeMap = NULL;
-    sourceAdjacentArcIndices = NULL;
-    sinkAdjacentArcIndices = NULL;
-    pdifferenceCache = NULL;
-
-    for(int i=0; i<2; i++)
-    {
-        arcListCache[i] = NULL;
-        nodeListCache[i] = NULL;
-        sourceSetCache[i] = NULL;
-        sinkSetCache[i] = NULL;
-    }
+/*************************************************************************
+isArcSaturated - Warm start bit of an arc of the super graph
+*************************************************************************/
+	return (arcBits[superArc >> 3] >> (superArc & 7)) & 1;
 }
 
-
-static void freeMemoryComplete(void)
+static __inline size_t sourceSetWords (const uint numNodes)
+{
 /*************************************************************************
-freeMemoryComplete
+sourceSetWords - Number of words of a source set of numNodes nodes
 *************************************************************************/
-{
-	/* destroy breakpoints */
-	destroyBreakpoint(firstBreakpoint);
-	firstBreakpoint = NULL;
-
-	free(nodeListSuper);
-	nodeListSuper = NULL;
-	free(arcListSuper);
-	arcListSuper = NULL;
+	return ((size_t) numNodes + SET_WORD_BITS - 1) / SET_WORD_BITS;
+}
 
-    freeCaches();
+static __inline int inSourceSet (const SetWord *sourceSet, const uint node)
+{
+/*************************************************************************
+inSourceSet - Source set bit of a node of the super graph
+*************************************************************************/
+	return (int) ((sourceSet[node / SET_WORD_BITS] >> (node % SET_WORD_BITS)) & 1);
 }
 
-static void freeMemorySolve (void)
+static __inline void assignSourceSet (SetWord *sourceSet, const uint node, const int inSource)
 {
 /*************************************************************************
-freeMemorySolve
+assignSourceSet - Put a node of the super graph on the source side if
+inSource is set, on the sink side otherwise
 *************************************************************************/
-	uint i;
+	SetWord bit = (SetWord) 1 << (node % SET_WORD_BITS);
 
-	for (i=0; i<numNodes; ++i)
+	if (inSource)
 	{
-		freeRoot (&strongRoots[i]);
+		sourceSet[node / SET_WORD_BITS] |= bit;
 	}
-
-	free(strongRoots);
-	strongRoots = NULL;
-
-	for (i=0; i<numNodes; ++i)
+	else
 	{
-		if (nodesList[i].outOfTree)
-		{
-			free(nodesList[i].outOfTree);
-			nodesList[i].outOfTree = NULL;
-		}
+		sourceSet[node / SET_WORD_BITS] &= ~bit;
 	}
-
-	free(labelCount);
-	labelCount = NULL;
 }
 
-static void processRoot (Node *strongRoot)
+static __inline uint countWord (SetWord word)
 {
 /*************************************************************************
-processRoot
+countWord - Number of set bits of a word
 *************************************************************************/
-  // printf("*** In processRoot\n");
-	Node *temp, *strongNode = strongRoot, *weakNode;
-	Arc *out;
+#ifdef __GNUC__
+	return (uint) __builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (uint) ((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
 
-	strongRoot->nextScan = strongRoot->childList;
+static __inline uint lowestBit (const SetWord word)
+{
+/*************************************************************************
+lowestBit - Index of the lowest set bit of a nonzero word
+*************************************************************************/
+#ifdef __GNUC__
+	return (uint) __builtin_ctzll(word);
+#else
+	uint bit = 0;
 
-	if ((out = findWeakNode (strongRoot, &weakNode)))
+	while (((word >> bit) & 1) == 0)
 	{
-		merge (weakNode, strongNode, out);
-		pushExcess (strongRoot);
-		return;
+		++bit;
 	}
+	return bit;
+#endif
+}
 
-	checkChildren (strongRoot);
-
-	while (strongNode)
+static __inline uint collectWord (SetWord word, const size_t wordIndex, uint *nodes, uint numNodes)
+{
+/*************************************************************************
+collectWord - Append the nodes of the set bits of word, the word at
+wordIndex of a source set, to nodes. Returns the new number of nodes.
+*************************************************************************/
+	while (word != 0)
 	{
-		while (strongNode->nextScan)
-		{
-			temp = strongNode->nextScan;
-			strongNode->nextScan = strongNode->nextScan->next;
-			strongNode = temp;
-			strongNode->nextScan = strongNode->childList;
-
-			if ((out = findWeakNode (strongNode, &weakNode)))
-			{
-				merge (weakNode, strongNode, out);
-				pushExcess (strongRoot);
-				return;
-			}
+		nodes[numNodes++] = (uint) (wordIndex * SET_WORD_BITS + lowestBit(word));
+		word &= word - 1;
+	}
+	return numNodes;
+}
 
-			checkChildren (strongNode);
-		}
+static uint countWordsScalar (const SetWord *sourceSet, const size_t numWords)
+{
+/*************************************************************************
+countWordsScalar - Number of set bits of numWords words
+*************************************************************************/
+	size_t i;
+	uint size = 0;
 
-		if ((strongNode = strongNode->parent))
-		{
-			checkChildren (strongNode);
-		}
+	for (i = 0; i < numWords; ++i)
+	{
+		size += countWord(sourceSet[i]);
 	}
-
-	addToStrongBucket (strongRoot, &strongRoots[strongRoot->label]);
-	++ highestStrongLabel;
+	return size;
 }
 
-
-static __inline void quickSort (Arc **arr, const uint first, const uint last)
+static uint differenceScalar (const SetWord *low, const SetWord *high, const size_t first,
+	const size_t numWords, uint *nodes, uint numNodes)
 {
 /*************************************************************************
-quickSort
+differenceScalar - Append the nodes set in high but not in low in the
+words from first to numWords to the numNodes nodes collected so far (see
+sourceSetDifference)
 *************************************************************************/
-	int i=0, j, L=first, R=last, beg[MAX_LEVELS], end[MAX_LEVELS], temp=0;
-	Arc *swap;
-
-	if ((R-L) <= 5)
-	{// Bubble sort if 5 elements or less
-		for (i=R; (i>L); --i)
-		{
-			swap = NULL;
-			for (j=L; j<i; ++j)
-			{
-				if (isExcess(arr[j]->flow - arr[j+1]->flow) < 0)//(arr[j]->flow < arr[j+1]->flow)
-				{
-					swap = arr[j];
-					arr[j] = arr[j+1];
-					arr[j+1] = swap;
-				}
-			}
+	size_t i;
 
-			if (!swap)
-			{
-				return;
-			}
-		}
+	for (i = first; i < numWords; ++i)
+	{
+		numNodes = collectWord(high[i] & ~low[i], i, nodes, numNodes);
+	}
+	return numNodes;
+}
 
-		return;
+#ifdef HPF_X86_SIMD
+__attribute__((target("avx2")))
+static uint countWordsAvx2 (const SetWord *sourceSet, const size_t numWords)
+{
+/*************************************************************************
+countWordsAvx2 - countWordsScalar on 256 bits at a time: the bit counts of
+the nibbles are looked up with a byte shuffle and summed per 64-bit lane
+*************************************************************************/
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i nibbles = _mm256_set1_epi8(0x0F);
+	__m256i sum = _mm256_setzero_si256();
+	__m256i block;
+	__m256i counts;
+	SetWord lanes[4];
+	size_t i;
+
+	for (i = 0; i + 4 <= numWords; i += 4)
+	{
+		block = _mm256_loadu_si256((const __m256i *) (sourceSet + i));
+		counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(block, nibbles)),
+			_mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibbles)));
+		sum = _mm256_add_epi64(sum, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
 	}
+	_mm256_storeu_si256((__m256i *) lanes, sum);
+	return (uint) (lanes[0] + lanes[1] + lanes[2] + lanes[3]) + countWordsScalar(sourceSet + i, numWords - i);
+}
 
-	beg[0]=first;
-	end[0]=last+1;
+__attribute__((target("avx2")))
+static uint differenceAvx2 (const SetWord *low, const SetWord *high, const size_t numWords, uint *nodes)
+{
+/*************************************************************************
+differenceAvx2 - differenceScalar on 256 bits at a time. Nested source
+sets mostly agree, so the blocks without a difference are skipped with a
+single test.
+*************************************************************************/
+	__m256i block;
+	size_t i, j;
+	uint numNodes = 0;
 
-	while (i>=0)
+	for (i = 0; i + 4 <= numWords; i += 4)
 	{
-		L=beg[i];
-		R=end[i]-1;
-
-		if (L<R)
+		block = _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *) (low + i)),
+			_mm256_loadu_si256((const __m256i *) (high + i)));
+		if (_mm256_testz_si256(block, block))
 		{
-			swap=arr[L];
-			while (L<R)
-			{
-				while ((isExcess(arr[R]->flow - swap->flow)>=0) && (L<R)) //((arr[R]->flow >= swap->flow) && (L<R))
-					R--;
-
-				if (L<R)
-				{
-					arr[L]=arr[R];
-					L++;
-				}
-
-				while ((isExcess(arr[L]->flow - swap->flow) <= 0) && (L<R)) //((arr[L]->flow <= swap->flow) && (L<R))
-					L++;
-
-				if (L<R)
-				{
-					arr[R]=arr[L];
-					R--;
-				}
-			}
-
-			arr[L] = swap;
-
-			beg[i+1] = L+1;
-			end[i+1] = end[i];
-			end[i++] = L;
-
-			if ((end[i]-beg[i]) > (end[i-1]-beg[i-1]))
-			{
-				temp=beg[i];
-				beg[i]=beg[i-1];
-				beg[i-1]=temp;
-				temp=end[i];
-				end[i]=end[i-1];
-				end[i-1]=temp;
-			}
+			continue;
 		}
-		else
+		for (j = i; j < i + 4; ++j)
 		{
-			i--;
+			numNodes = collectWord(high[j] & ~low[j], j, nodes, numNodes);
 		}
 	}
+	return differenceScalar(low, high, i, numWords, nodes, numNodes);
 }
 
-static __inline void sort (Node * current)
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static uint countWordsAvx512 (const SetWord *sourceSet, const size_t numWords)
 {
 /*************************************************************************
-sort
+countWordsAvx512 - countWordsScalar on 512 bits at a time with the 64-bit
+lane popcount of AVX-512 VPOPCNTDQ
 *************************************************************************/
-	if (current->numOutOfTree > 1)
+	__m512i sum = _mm512_setzero_si512();
+	size_t i;
+
+	for (i = 0; i + 8 <= numWords; i += 8)
 	{
-		quickSort (current->outOfTree, 0, (current->numOutOfTree-1));
+		sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_loadu_si512((const void *) (sourceSet + i))));
 	}
+	return (uint) _mm512_reduce_add_epi64(sum) + countWordsScalar(sourceSet + i, numWords - i);
 }
 
-static __inline void minisort (Node *current)
+__attribute__((target("avx512f")))
+static uint differenceAvx512 (const SetWord *low, const SetWord *high, const size_t numWords, uint *nodes)
 {
 /*************************************************************************
-minisort
+differenceAvx512 - differenceAvx2 on 512 bits at a time. The lane mask of
+a block tells which of its words hold a difference.
 *************************************************************************/
-	Arc *temp = current->outOfTree[current->nextArc];
-	uint i, size = current->numOutOfTree;/*, tempflow = temp->flow;*/
-	double tempflow = temp->flow;
+	__m512i block;
+	__mmask8 lanes;
+	size_t i, j;
+	uint numNodes = 0;
 
-	for(i=current->nextArc+1; ((i<size) && (isExcess(tempflow - current->outOfTree[i]->flow) < 0)); ++i)
+	for (i = 0; i + 8 <= numWords; i += 8)
 	{
-		current->outOfTree[i-1] = current->outOfTree[i];
+		block = _mm512_andnot_si512(_mm512_loadu_si512((const void *) (low + i)),
+			_mm512_loadu_si512((const void *) (high + i)));
+		for (lanes = _mm512_test_epi64_mask(block, block); lanes != 0; lanes &= lanes - 1)
+		{
+			j = i + lowestBit(lanes);
+			numNodes = collectWord(high[j] & ~low[j], j, nodes, numNodes);
+		}
 	}
-	current->outOfTree[i-1] = temp;
+	return differenceScalar(low, high, i, numWords, nodes, numNodes);
 }
+#endif
 
+static uint sourceSetSize (HpfContext *ctx, const SetWord *sourceSet)
+{
+/*************************************************************************
+sourceSetSize - Number of nodes in a source set of the super graph
+*************************************************************************/
+	size_t numWords = sourceSetWords(ctx->numNodesSuper);
 
-// static /*ullint*/double checkOptimality (const uint gap)
-// {
-// /*************************************************************************
-// checkOptimality
-// *************************************************************************/
-// 	uint i, check = 1;
-// 	/*ullint*/double mincut = 0;
-// 	/*llint*/ double *excess = NULL;
-//
-// 	Arc *tempArc;
-//
-// 	excess = (/*llint*/double *) malloc (numNodes * sizeof (double/*llint*/));
-// 	if (!excess)
-// 	{
-// 		printf("Out of memory\n");
-// 		exit(0);
-// 	}
-//
-// 	// Pushing depicits from all sink adjacent nodes to the sink
-// 	for (i=0; i<nodesList[sink].numOutOfTree; ++i)
-// 	{
-// 		tempArc = nodesList[sink].outOfTree[i];
-// 		if (isExcess(tempArc->from->excess) < 0)
-// 		{
-// 			if (isExcess((tempArc->from->excess + /*(int)*/ tempArc->flow))  < 0)
-// 			{
-// 				// Excess is high enough to saturate the arc => Flow on residual arc is zeroed
-// 				tempArc->from->excess += /*(int)*/ tempArc->flow;
-// 				tempArc->flow = 0;
-// 			}
-// 			else
-// 				// Excess is NOT high enough to saturate the arc => Excess is zeroed
-// 			{
-// 				tempArc->flow = /*(uint)*/ (tempArc->from->excess + /*(int)*/ tempArc->flow);
-// 				tempArc->from->excess = 0;
-// 			}
-// 		}
-// 	}
-//
-// 	for (i=0; i<numNodes; ++i)
-// 	{
-// 		excess[i] = 0;
-// 	}
-//
-// 	for (i=0; i<numArcs; ++i)
-// 	{
-// 		if ((arcList[i].from->label >= gap) && (arcList[i].to->label < gap))
-// 		{
-// 			mincut += arcList[i].capacity;
-// 		}
-//
-// 		if ((isExcess(arcList[i].flow - arcList[i].capacity)>0) || (isExcess(arcList[i].flow) < 0))
-// 		{
-// 			check = 0;
-// 			printf("Warning - Capacity constraint violated on arc (%d, %d). Flow = %lf, capacity = %lf\n",
-// 				   arcList[i].from->number,
-// 				   arcList[i].to->number,
-// 				   arcList[i].flow,
-// 				   arcList[i].capacity);
-// 		}
-// 		excess[arcList[i].from->number - 1] -= arcList[i].flow;
-// 		excess[arcList[i].to->number - 1] += arcList[i].flow;
-// 	}
-//
-// 	for (i=0; i<numNodes; i++)
-// 	{
-// 		if ((i != (source)) && (i != (sink)))
-// 		{
-// 			if (isExcess(excess[i]))
-// 			{
-// 				check = 0;
-// 				printf ("Warning - Flow balance constraint violated in node %d. Excess = %lf\n",
-// 						i+1,
-// 						excess[i]);
-// 			}
-// 		}
-// 	}
-//
-// 	check = 1;
-//
-// 	if (isExcess(excess[sink] - mincut) != 0)//(excess[sink] != mincut)
-// 	{
-// 		check = 0;
-// 		printf("Warning - Flow is not optimal - max flow does not equal min cut!\n");
-// 	}
-//
-// // 	if (check)
-// // 	{
-// // 		printf ("Solution checks as optimal. \t Max Flow: \t %lld\n", mincut);
-// // 	}
-//
-// 	free (excess);
-// 	excess = NULL;
-// 	return mincut;
-// }
+#ifdef HPF_X86_SIMD
+	if (__builtin_cpu_supports("avx512vpopcntdq"))
+	{
+		return countWordsAvx512(sourceSet, numWords);
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return countWordsAvx2(sourceSet, numWords);
+	}
+#endif
+	return countWordsScalar(sourceSet, numWords);
+}
 
-// static void decompose (Node *excessNode, const uint source, uint *iteration)
-// {
-// /*************************************************************************
-// decompose
-// *************************************************************************/
-// 	Node *current = excessNode;
-// 	Arc *tempArc;
-// 	/*uint*/double bottleneck = excessNode->excess;
-//
-// 	// Find the bottleneck along a path to the source or on a cycle
-// 	for ( ;(current->number != source) && (current->visited < (*iteration)) /*&& (current->nextArc < current->numOutOfTree)*/; // Added by Cheng
-// 		 current = tempArc->from)
-// 	{
-// 		current->visited = (*iteration);
-// 		tempArc = current->outOfTree[current->nextArc];
-//
-// 		if (isExcess(tempArc->flow - bottleneck) < 0) //(tempArc->flow < bottleneck)
-// 		{
-// 			bottleneck = tempArc->flow;
-// 		}
-// 	}
-//
-// 	if (current->number == source) // the DFS reached the source
-// 	{
-// 		excessNode->excess -= bottleneck;
-// 		current = excessNode;
-//
-// 		// Push the excess all the way to the source
-// 		while (current->number != source)
-// 		{
-// 			tempArc = current->outOfTree[current->nextArc]; // Pick arc going out of node to push excess to
-// 			tempArc->flow -= bottleneck; // Push back bottleneck excess on this arc
-//
-// 			if (isFlow(tempArc->flow)) // If there is still flow on this arc do sort on this current node
-// 			{
-// 				minisort(current);
-// 			} else {
-// 				++ current->nextArc;
-// 			}
-//
-// 			current = tempArc->from;
-// 		}
-// 		return;
-// 	}
-//
-// 	++ (*iteration);
-//
-// 	// This part is temporarily added by Cheng Lu.
-// //	if (current->visited == (*iteration)-1)
-// 		bottleneck = current->outOfTree[current->nextArc]->flow;
-// /*	else{
-// 		current = excessNode;
-// 		bottleneck = excessNode->excess;
-// 	}*/
-//
-// 	while (current->visited < (*iteration)) //&& (current->nextArc < current->numOutOfTree)) // Added by Cheng
-// 	{
-// 		current->visited = (*iteration);
-// 		tempArc = current->outOfTree[current->nextArc];
-//
-// 		if (isExcess(tempArc->flow - bottleneck) < 0)//(tempArc->flow < bottleneck)
-// 		{
-// 			bottleneck = tempArc->flow;
-// 		}
-// 		current = tempArc->from;
-// 	}
-//
-// 	++ (*iteration);
-//
-// 	// This part is temporarily added by Cheng Lu.
-// /*	if (current->visited == (*iteration)-1)
-// 		;
-// 	else{
-// 		current = excessNode;
-// 	}*/
-//
-// 	while (current->visited < (*iteration)) //&& (current->nextArc < current->numOutOfTree)) // Added by Cheng
-// 	{
-// 		current->visited = (*iteration);
-//
-// 		tempArc = current->outOfTree[current->nextArc];
-// 		tempArc->flow -= bottleneck;
-//
-// 		if (isFlow(tempArc->flow))
-// 		{
-// 			minisort(current);
-// 			current = tempArc->from;
-// 		} else {
-// 			++ current->nextArc;
-// 			current = tempArc->from;
-// 		}
-// 	}
-// }
+static uint sourceSetDifference (HpfContext *ctx, const SetWord *low, const SetWord *high, uint *nodes)
+{
+/*************************************************************************
+sourceSetDifference - Store the nodes in the source set high but not in
+the source set low in nodes, in increasing order, and return their number.
+nodes holds at least the difference of the sizes of the sets, which are
+nested.
+*************************************************************************/
+	size_t numWords = sourceSetWords(ctx->numNodesSuper);
 
-// static void recoverFlow (const uint gap)
-// {
-// /*************************************************************************
-// recoverFlow
-// *************************************************************************/
-// 	uint iteration = 1;
-// 	uint i, j;
-// 	Arc *tempArc;
-// 	Node *tempNode;
-//
-// 	Node **nodePtrArray;
-//
-// 	if ((nodePtrArray = (Node **) malloc (numNodes * sizeof (Node *))) == NULL)
-// 	{
-// 		printf("Out of memory\n");
-// 		exit(0);
-// 	}
-//
-// 	for (i=0; i < numNodes ; i++)
-// 		nodePtrArray[i] = &nodesList[i];
-//
-// 	// Adding arcs FROM the Source to Source adjacent nodes.
-// 	for (i=0; i<nodesList[source].numOutOfTree; ++i)
-// 	{
-// 		tempArc = nodesList[source].outOfTree[i];
-// 		addOutOfTreeNode (tempArc->to, tempArc);
-// 	}
-//
-// 	// Zeroing excess on source and sink nodes
-// 	nodesList[source].excess = 0;
-// 	nodesList[sink].excess = 0;
-//
-// 	for (i=0; i<numNodes; ++i)
-// 	{
-// 		tempNode = &nodesList[i];
-//
-// 		if ((i == (source)) || (i == (sink)))
-// 		{
-// 			continue;
-// 		}
-//
-// 		if (tempNode->label >= gap) //tempNode is in SINK set
-// 		{
-// 			tempNode->nextArc = 0;
-// 			if ((tempNode->parent) && (isFlow(tempNode->arcToParent->flow)))
-// 			{
-// 				addOutOfTreeNode (tempNode->arcToParent->to, tempNode->arcToParent);
-// 			}
-//
-// 			for (j=0; j<tempNode->numOutOfTree; ++j)
-// 			{ // go over all sink-set-node's arcs and look for arc with NO flow
+#ifdef HPF_X86_SIMD
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return differenceAvx512(low, high, numWords, nodes);
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return differenceAvx2(low, high, numWords, nodes);
+	}
+#endif
+	return differenceScalar(low, high, 0, numWords, nodes, 0);
+}
+
+static __inline uint floorLog2 (const uint value)
+{
+/*************************************************************************
+floorLog2 - Index of the highest set bit of a nonzero value
+*************************************************************************/
+#ifdef __GNUC__
+	return 31 - (uint) __builtin_clz(value);
+#else
+	uint bit = 0;
+
+	while ((value >> bit) > 1)
+	{
+		++bit;
+	}
+	return bit;
+#endif
+}
+
+static __inline const ChainEntry * chainEntry (const HpfContext *ctx, const uint entry)
+{
+/*************************************************************************
+chainEntry - Lambda value and order of an entry of the chain of source
+sets. Block b holds the entries from CHAIN_BLOCK * (2^b - 1) on.
+*************************************************************************/
+	uint block = floorLog2(entry / CHAIN_BLOCK + 1);
+
+	return &ctx->root->chainBlocks[block][entry - CHAIN_BLOCK * ((1u << block) - 1)];
+}
+
+static uint addChainEntry (HpfContext *ctx, const Lambda lambdaValue, const double order)
+{
+/*************************************************************************
+addChainEntry - New entry of the chain of source sets. Entries are only
+added, so the entries already handed out stay in place. A chain that
+cannot grow, because its entries run out of indices or blocks or its block
+cannot be allocated, unwinds ctx with HPF_ERROR_OUT_OF_MEMORY.
+*************************************************************************/
+	HpfContext *root = ctx->root;
+	uint entry, block;
+	ChainEntry *chain;
+
+	lockShared(ctx);
+	entry = root->numChainEntries;
+	block = floorLog2(entry / CHAIN_BLOCK + 1);
+	if (entry == NONE || block >= CHAIN_BLOCKS || (root->chainBlocks[block] == NULL
+		&& (root->chainBlocks[block] = (ChainEntry *)malloc(((size_t) CHAIN_BLOCK << block) * sizeof(ChainEntry))) == NULL))
+	{
+		unlockShared(ctx);
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+	++root->numChainEntries;
+	chain = &root->chainBlocks[block][entry - CHAIN_BLOCK * ((1u << block) - 1)];
+	chain->lambdaValue = lambdaValue;
+	chain->order = order;
+	unlockShared(ctx);
+	return entry;
+}
+
+static __inline uint joinEntry (const HpfContext *ctx, const uint node)
+{
+/*************************************************************************
+joinEntry - Entry at which a node of the super graph joins the source
+set, or the upper endpoint of the interval it is free in. The thread that
+processes that interval moves it down while others read it, both values
+are on the same side of any other interval.
+*************************************************************************/
+	return __atomic_load_n(&ctx->root->joinEntries[node], __ATOMIC_ACQUIRE);
+}
+
+static __inline void setJoinEntry (HpfContext *ctx, const uint node, const uint entry)
+{
+/*************************************************************************
+setJoinEntry
+*************************************************************************/
+	__atomic_store_n(&ctx->root->joinEntries[node], entry, __ATOMIC_RELEASE);
+}
+
+static int joinsBy (const HpfContext *ctx, const uint entry, const uint bound)
+{
+/*************************************************************************
+joinsBy - Whether a node that joins the source set at entry is in the
+source set of the entry bound
+*************************************************************************/
+	const ChainEntry *joined;
+	const ChainEntry *limit;
+	int compare;
+
+	if (entry == bound)
+	{
+		return 1;
+	}
+	joined = chainEntry(ctx, entry);
+	limit = chainEntry(ctx, bound);
+	compare = lambdaCompare(joined->lambdaValue, limit->lambdaValue);
+	return compare < 0 || (compare == 0 && joined->order <= limit->order);
+}
+
+static __inline uint sourceSetIndex (const CutProblem *problem, const uint i)
+{
+/*************************************************************************
+sourceSetIndex - Bit of node i of the graph of problem in its source set
+indicator: the node of the super graph for a graph of all nodes, the
+position among the free nodes for a contracted graph
+*************************************************************************/
+	return problem->lowEntry == NONE ? (uint) problem->nodeInfo[i].originalIndex : i - 2;
+}
+
+static int inSourceSetOf (const HpfContext *ctx, const CutProblem *problem, const uint node)
+{
+/*************************************************************************
+inSourceSetOf - Whether a node of the super graph is in the source set of
+a solved problem. While the problem holds its indicator, a contracted node
+is on the side it is contracted to and a free node is found through the
+nodeMap of the last contraction of ctx, which built the graph of the
+problem. Afterwards the chain decides.
+*************************************************************************/
+	uint entry;
+
+	if (problem->optimalSourceSetIndicator == NULL)
+	{
+		return joinsBy(ctx, joinEntry(ctx, node), problem->entry);
+	}
+	if (problem->lowEntry == NONE)
+	{
+		return inSourceSet(problem->optimalSourceSetIndicator, node);
+	}
+	if (node == ctx->sourceSuper || node == ctx->sinkSuper)
+	{
+		return node == ctx->sourceSuper;
+	}
+	entry = joinEntry(ctx, node);
+	if (entry == problem->highEntry)
+	{
+		return inSourceSet(problem->optimalSourceSetIndicator, (uint) ctx->nodeMap[node] - 2);
+	}
+	return joinsBy(ctx, entry, problem->lowEntry);
+}
+
+static void liftAll (HpfContext *ctx, const uint rootNode)
+{
+/*************************************************************************
+liftAll
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	uint temp, current=rootNode;
+
+	nodes[current].nextScan = nodes[current].childList;
+
+	-- ctx->labelCount[ctx->labels[current]];
+	ctx->labels[current] = ctx->numNodes;
+
+	for ( ; (current != NONE); current = nodes[current].parent)
+	{
+		while (nodes[current].nextScan != NONE)
+		{
+			temp = nodes[current].nextScan;
+			nodes[current].nextScan = nodes[temp].next;
+			current = temp;
+			nodes[current].nextScan = nodes[current].childList;
+
+			-- ctx->labelCount[ctx->labels[current]];
+			ctx->labels[current] = ctx->numNodes;
+		}
+	}
+}
+static void addOutOfTreeNode (HpfContext *ctx, const uint n, const uint out)
+{
+/*************************************************************************
+addOutOfTreeNode
+*************************************************************************/
+	outOfTreeArcs(ctx, n)[ctx->nodesList[n].numOutOfTree] = out;
+	++ ctx->nodesList[n].numOutOfTree;
+}
+
+static uint sum_array_uint(uint *array, uint num_elements)
+{
+    uint sum = 0;
+    for (uint i = 0; i< num_elements; i++)
+    {
+        sum += array[i];
+    }
+    return sum;
+}
+
+static void addToStrongBucket (Node *nodes, const uint newRoot, Root *rootBucket)
+{
+/*************************************************************************
+addToStrongBucket
+*************************************************************************/
+	if (rootBucket->start != NONE)
+	{
+		nodes[rootBucket->end].next = newRoot;
+		rootBucket->end = newRoot;
+		nodes[newRoot].next = NONE;
+	}
+	else
+	{
+		rootBucket->start = newRoot;
+		rootBucket->end = newRoot;
+		nodes[newRoot].next = NONE;
+	}
+}
+
+static __inline int addRelationship (Node *nodes, const uint newParent, const uint child)
+{
+/*************************************************************************
+addRelationship
+*************************************************************************/
+	nodes[child].parent = newParent;
+	nodes[child].next = nodes[newParent].childList;
+
+#ifdef PREV_CHILDLIST
+    if (nodes[newParent].childList != NONE)
+    {
+        nodes[nodes[newParent].childList].prev = child;
+    }
+#endif
+
+	nodes[newParent].childList = child;
+	return 0;
+}
+
+static __inline void breakRelationship (Node *nodes, const uint oldParent, const uint child)
+{
+/*************************************************************************
+breakRelationship
+*************************************************************************/
+	uint current;
+
+	nodes[child].parent = NONE;
+
+	if (nodes[oldParent].childList == child)
+	{
+		nodes[oldParent].childList = nodes[child].next;
+		nodes[child].next = NONE;
+		return;
+	}
+#ifdef PREV_CHILDLIST
+    current = nodes[child].prev;
+    if (nodes[child].next != NONE) nodes[nodes[child].next].prev = current;
+
+#else
+	for (current = nodes[oldParent].childList; (nodes[current].next != child); current = nodes[current].next);
+#endif
+	nodes[current].next = nodes[child].next;
+	nodes[child].next = NONE;
+}
+
+static void merge (HpfContext *ctx, const uint parent, const uint child, uint newArc)
+{
+/*************************************************************************
+merge
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	uint oldArc;
+	uint current = child, oldParent, newParent = parent;
+
+	++ ctx->numMergers;
+
+	while (nodes[current].parent != NONE)
+	{
+		oldArc = nodes[current].arcToParent;
+		nodes[current].arcToParent = newArc;
+		oldParent = nodes[current].parent;
+		breakRelationship (nodes, oldParent, current);
+		addRelationship (nodes, newParent, current);
+		newParent = current;
+		current = oldParent;
+		newArc = oldArc;
+		ctx->arcList[newArc].direction = 1 - ctx->arcList[newArc].direction;
+	}
+
+	nodes[current].arcToParent = newArc;
+	addRelationship (nodes, newParent, current);
+}
+
+
+static __inline void pushUpward (HpfContext *ctx, const uint currentArc, const uint child, const uint parent, const Capacity resCap)
+{
+/*************************************************************************
+pushUpward
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	Arc *arc = &ctx->arcList[currentArc];
+
+	++ ctx->numPushes;
+
+	if (isExcess(resCap-nodes[child].excess) >= 0)//(/*(int)*/resCap >= child->excess)
+	{
+		nodes[parent].excess += nodes[child].excess;
+		arc->flow += nodes[child].excess;
+		nodes[child].excess = 0;
+		return;
+	}
+
+	arc->direction = 0;
+	nodes[parent].excess += resCap;
+	nodes[child].excess -= resCap;
+	arc->flow = arc->capacity;
+	addOutOfTreeNode (ctx, parent, currentArc);
+	breakRelationship (nodes, parent, child);
+
+	addToStrongBucket (nodes, child, &ctx->strongRoots[ctx->labels[child]]);
+}
+
+
+static __inline void pushDownward (HpfContext *ctx, const uint currentArc, const uint child, const uint parent, Capacity flow)
+{
+/*************************************************************************
+pushDownward
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	Arc *arc = &ctx->arcList[currentArc];
+
+	++ ctx->numPushes;
+
+	if (isExcess(flow - nodes[child].excess) >= 0)//(/*(int)*/flow >= child->excess)
+	{
+		nodes[parent].excess += nodes[child].excess;
+		arc->flow -= nodes[child].excess;
+		nodes[child].excess = 0;
+		return;
+	}
+
+	arc->direction = 1;
+	nodes[child].excess -= flow;
+	nodes[parent].excess += flow;
+	arc->flow = 0;
+	addOutOfTreeNode (ctx, parent, currentArc);
+	breakRelationship (nodes, parent, child);
+
+	addToStrongBucket (nodes, child, &ctx->strongRoots[ctx->labels[child]]);
+}
+
+static void printCutProblem(HpfContext *ctx, CutProblem *p){
+    // printf("numNodes: %u\n " ,p->numNodesInList);
+    // printf("numArcs: %u\n" ,p->numArcs);
+    printf("c solved: %u\n" ,p->solved);
+    printf("c lambda:%.12lf\n" ,lambdaToDouble(p->lambdaValue));
+    int i;
+    // printf("[from, to](capacity,constant,multiplier)\n");
+    // for(i=0;i<p->numArcs;++i)
+    // {
+    //     printf("[%d,%d](%.12lf,%.12lf,%.12lf)\n",p->arcList[i].from->originalIndex,p->arcList[i].to->originalIndex,p->arcList[i].capacity,p->arcList[i].constant,p->arcList[i].multiplier);
+    // }
+    // printf("\n");
+    //printArcListInfo(arcList);
+    //printNodeListInfo(nodeList);
+    printf("c Cut value is %.12lf\n" ,(double) p->cutValue / lambdaScale(p->lambdaValue));
+    // printNodeListInfo(sourceSet);
+    // printSinkListInfo(sinkSet);
+    if (p->solved == 1)
+    {
+				int sourcenodes = 0;
+        for(i=0;i<ctx->numNodesSuper;++i)
+        {
+					sourcenodes += inSourceSetOf(ctx, p, i);
+          printf("%u ",inSourceSetOf(ctx, p, i));
+        }
+				printf("\n");
+				printf("Nodes in source set: %d\n", sourcenodes);
+    }
+    // printf("SourceSuper: %d, SinkSuper: %d\n", sourceSuper, sinkSuper);
+    printf("\n");
+    printf("\n");
+}
+
+static void pushExcess (HpfContext *ctx, const uint strongRoot)
+{
+/*************************************************************************
+pushExcess
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	uint current, parent;
+	Arc *arcToParent;
+	Capacity prevEx=1;
+
+	for (current = strongRoot; (isExcess(nodes[current].excess) && nodes[current].parent != NONE); current = parent)
+	{
+		parent = nodes[current].parent;
+		prevEx = nodes[parent].excess;
+
+		arcToParent = &ctx->arcList[nodes[current].arcToParent];
+
+		if (arcToParent->direction)
+		{
+			pushUpward (ctx, nodes[current].arcToParent, current, parent, (arcToParent->capacity - arcToParent->flow));
+		}
+		else
+		{
+			pushDownward (ctx, nodes[current].arcToParent, current, parent, arcToParent->flow);
+		}
+	}
+
+	if ((isExcess(nodes[current].excess) > 0) && (isExcess(prevEx) <= 0))
+	{
+		addToStrongBucket (nodes, current, &ctx->strongRoots[ctx->labels[current]]);
+	}
+}
+
+
+static uint findWeakNode (HpfContext *ctx, const uint strongNode, uint *weakNode)
+{
+/*************************************************************************
+findWeakNode - Returns the arc to a weak node with label
+highestStrongLabel-1, or NONE
+*************************************************************************/
+	Node *strong = &ctx->nodesList[strongNode];
+	const uint *labels = ctx->labels;
+	const uint weakLabel = ctx->highestStrongLabel-1;
+	uint i, size, out;
+	uint *outOfTree = outOfTreeArcs(ctx, strongNode);
+	Arc *arc;
+
+	size = strong->numOutOfTree;
+
+	for (i=strong->nextArc; i<size; ++i)
+	{
+		++ ctx->numArcScans;
+		out = outOfTree[i];
+		arc = &ctx->arcList[out];
+		if (labels[arc->to] == weakLabel)
+		{
+			strong->nextArc = i;
+			(*weakNode) = arc->to;
+			-- strong->numOutOfTree;
+			outOfTree[i] = outOfTree[strong->numOutOfTree];
+			return (out);
+		} else if (labels[arc->from] == weakLabel) {
+			strong->nextArc = i;
+			(*weakNode) = arc->from;
+			-- strong->numOutOfTree;
+			outOfTree[i] = outOfTree[strong->numOutOfTree];
+			return (out);
+		}
+	}
+
+	strong->nextArc = strong->numOutOfTree;
+
+	return NONE;
+}
+
+
+static void checkChildren (HpfContext *ctx, const uint curNode)
+{
+/*************************************************************************
+checkChildren
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	Node *current = &nodes[curNode];
+	uint *labels = ctx->labels;
+
+	for ( ; (current->nextScan != NONE); current->nextScan = nodes[current->nextScan].next)
+	{
+		if (labels[current->nextScan] == labels[curNode])
+		{
+			return;
+		}
+
+	}
+
+	-- ctx->labelCount[labels[curNode]];
+	++	labels[curNode];
+	++ ctx->labelCount[labels[curNode]];
+
+	++ctx->numRelabels;
+
+	current->nextArc = 0;
+}
+
+
+static void simpleInitialization (HpfContext *ctx)
+{
+/*************************************************************************
+simpleInitialization - Saturate the source and sink arcs: every node
+starts with its source capacity less its sink capacity as excess, on top
+of the excess of a warm start
+*************************************************************************/
+	uint i;
+
+	for (i=2; i<ctx->numNodes; ++i)
+	{
+		ctx->nodesList[i].excess += ctx->sourceCapacity[i];
+		ctx->nodesList[i].excess -= ctx->sinkCapacity[i];
+	}
+
+	ctx->nodesList[ctx->source].excess = 0; // zeroing source excess
+	ctx->nodesList[ctx->sink].excess = 0;	// zeroing sink excess
+
+	for (i=0; i<ctx->numNodes; ++i)
+	{
+		if (isExcess(ctx->nodesList[i].excess) > 0)
+		{
+		    ctx->labels[i] = 1;
+			++ ctx->labelCount[1];
+
+			addToStrongBucket (ctx->nodesList, i, &ctx->strongRoots[1]);
+		}
+	}
+
+	ctx->labels[ctx->source] = ctx->numNodes;	// Set the source label to n
+	ctx->labels[ctx->sink] = 0;			// set the sink label to 0
+	ctx->labelCount[0] = (ctx->numNodes - 2) - ctx->labelCount[1];
+}
+
+
+static uint getHighestStrongRoot (HpfContext *ctx)
+{
+/*************************************************************************
+getHighestStrongRoot
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	uint i;
+	uint strongRoot;
+
+	for (i=ctx->highestStrongLabel; i>0; --i)
+	{
+		if (ctx->strongRoots[i].start != NONE)
+		{
+			ctx->highestStrongLabel = i;
+			if (ctx->labelCount[i-1])
+			{
+				strongRoot = ctx->strongRoots[i].start;
+				ctx->strongRoots[i].start = nodes[strongRoot].next;
+				nodes[strongRoot].next = NONE;
+				return strongRoot;
+			}
+
+			while (ctx->strongRoots[i].start != NONE)
+			{
+				++ ctx->numGaps;
+
+				strongRoot = ctx->strongRoots[i].start;
+				ctx->strongRoots[i].start = nodes[strongRoot].next;
+				liftAll (ctx, strongRoot);
+			}
+		}
+	}
+
+	if (ctx->strongRoots[0].start == NONE)
+	{
+		return NONE;
+	}
+
+	while (ctx->strongRoots[0].start != NONE)
+	{
+		strongRoot = ctx->strongRoots[0].start;
+		ctx->strongRoots[0].start = nodes[strongRoot].next;
+		ctx->labels[strongRoot] = 1;
+		-- ctx->labelCount[0];
+		++ ctx->labelCount[1];
+
+		++ ctx->numRelabels;
+
+		addToStrongBucket (nodes, strongRoot, &ctx->strongRoots[ctx->labels[strongRoot]]);
+	}
+
+	ctx->highestStrongLabel = 1;
+
+	strongRoot = ctx->strongRoots[1].start;
+	ctx->strongRoots[1].start = nodes[strongRoot].next;
+	nodes[strongRoot].next = NONE;
+
+	return strongRoot;
+}
+
+
+
+static void initializeRoot (Root *rt)
+{
+/*************************************************************************
+initializeRoot
+*************************************************************************/
+	rt->start = NONE;
+	rt->end = NONE;
+}
+
+
+static void initializeNode (Node *nd)
+{
+/*************************************************************************
+initializeNode
+*************************************************************************/
+	nd->excess = 0.0;
+	nd->parent = NONE;
+	nd->childList = NONE;
+	nd->nextScan = NONE;
+	nd->nextArc = 0;
+	nd->numOutOfTree = 0;
+	nd->arcToParent = NONE;
+	nd->next = NONE;
+#ifdef PREV_CHILDLIST
+	nd->prev= NONE;
+#endif
+}
+
+static void initializeNodeInfo (NodeInfo *info)
+{
+/*************************************************************************
+initializeNodeInfo
+*************************************************************************/
+	info->numAdjacent = 0;
+	info->originalIndex = -10;
+}
+
+static void destroyBreakpoint(Breakpoint *currentBreakpoint)
+/*************************************************************************
+destroyBreakpoint - Removes breakpoint and subsequent ones
+*************************************************************************/
+{
+	Breakpoint *nextBreakpoint;
+
+	/* iterate through breakpoint list */
+	while (currentBreakpoint != NULL)
+	{
+		nextBreakpoint = currentBreakpoint->next;
+
+    	/* free breakpoint */
+    	free(currentBreakpoint);
+		currentBreakpoint = nextBreakpoint;
+	}
+}
+
+static void freeRoot (Root *rt)
+{
+/*************************************************************************
+freeRoot
+*************************************************************************/
+	rt->start = NONE;
+	rt->end = NONE;
+}
+
+static void freeCaches(HpfContext *ctx)
+{
+
+    if(ctx->joinEntries!=NULL) free(ctx->joinEntries);
+    for(int i=0; i<CHAIN_BLOCKS; i++)
+    {
+        if(ctx->chainBlocks[i]!=NULL) free(ctx->chainBlocks[i]);
+        ctx->chainBlocks[i] = NULL;
+    }
+    if(ctx->nodeMap!=NULL) free(ctx->nodeMap);
+    if(ctx->intervals!=NULL) free(ctx->intervals);
+
+    freePool(ctx);
+
+    ctx->joinEntries = NULL;
+    ctx->numChainEntries = 0;
+    ctx->nodeMap = NULL;
+    ctx->intervals = NULL;
+    ctx->intervalsSize = 0;
+}
+
+
+static void freeMemoryComplete(HpfContext *ctx)
+/*************************************************************************
+freeMemoryComplete
+*************************************************************************/
+{
+	/* destroy breakpoints */
+	destroyBreakpoint(ctx->firstBreakpoint);
+	ctx->firstBreakpoint = NULL;
+
+	free(ctx->nodeListSuper);
+	ctx->nodeListSuper = NULL;
+	free(ctx->arcListSuper);
+	ctx->arcListSuper = NULL;
+	free(ctx->superIncidenceOffsets);
+	ctx->superIncidenceOffsets = NULL;
+	free(ctx->superIncidentArcs);
+	ctx->superIncidentArcs = NULL;
+	free(ctx->nodeBreakpoints);
+	ctx->nodeBreakpoints = NULL;
+
+	arenaFree(&ctx->arena);
+
+    freeCaches(ctx);
+}
+
+static void freeMemorySolve (HpfContext *ctx)
+{
+/*************************************************************************
+freeMemorySolve
+*************************************************************************/
+	uint i;
+
+	for (i=0; i<ctx->numNodes; ++i)
+	{
+		freeRoot (&ctx->strongRoots[i]);
+	}
+
+	/* the solve structures are carved from the arena and returned by the caller */
+	ctx->strongRoots = NULL;
+	ctx->outOfTreeOffsets = NULL;
+	ctx->outOfTreeArcs = NULL;
+	ctx->labelCount = NULL;
+	ctx->labels = NULL;
+}
+
+static void processRoot (HpfContext *ctx, const uint strongRoot)
+{
+/*************************************************************************
+processRoot
+*************************************************************************/
+  // printf("*** In processRoot\n");
+	Node *nodes = ctx->nodesList;
+	uint temp, strongNode = strongRoot, weakNode;
+	uint out;
+
+	nodes[strongRoot].nextScan = nodes[strongRoot].childList;
+
+	if ((out = findWeakNode (ctx, strongRoot, &weakNode)) != NONE)
+	{
+		merge (ctx, weakNode, strongNode, out);
+		pushExcess (ctx, strongRoot);
+		return;
+	}
+
+	checkChildren (ctx, strongRoot);
+
+	while (strongNode != NONE)
+	{
+		while (nodes[strongNode].nextScan != NONE)
+		{
+			temp = nodes[strongNode].nextScan;
+			nodes[strongNode].nextScan = nodes[temp].next;
+			strongNode = temp;
+			nodes[strongNode].nextScan = nodes[strongNode].childList;
+
+			if ((out = findWeakNode (ctx, strongNode, &weakNode)) != NONE)
+			{
+				merge (ctx, weakNode, strongNode, out);
+				pushExcess (ctx, strongRoot);
+				return;
+			}
+
+			checkChildren (ctx, strongNode);
+		}
+
+		if ((strongNode = nodes[strongNode].parent) != NONE)
+		{
+			checkChildren (ctx, strongNode);
+		}
+	}
+
+	addToStrongBucket (nodes, strongRoot, &ctx->strongRoots[ctx->labels[strongRoot]]);
+	++ ctx->highestStrongLabel;
+}
+
+
+static __inline void quickSort (HpfContext *ctx, uint *arr, const uint first, const uint last)
+{
+/*************************************************************************
+quickSort
+*************************************************************************/
+	int i=0, j, L=first, R=last, beg[MAX_LEVELS], end[MAX_LEVELS], temp=0;
+	uint swap, swapped;
+	const Arc *arcs = ctx->arcList;
+
+	if ((R-L) <= 5)
+	{// Bubble sort if 5 elements or less
+		for (i=R; (i>L); --i)
+		{
+			swapped = FALSE;
+			for (j=L; j<i; ++j)
+			{
+				if (isExcess(arcs[arr[j]].flow - arcs[arr[j+1]].flow) < 0)//(arr[j]->flow < arr[j+1]->flow)
+				{
+					swap = arr[j];
+					arr[j] = arr[j+1];
+					arr[j+1] = swap;
+					swapped = TRUE;
+				}
+			}
+
+			if (!swapped)
+			{
+				return;
+			}
+		}
+
+		return;
+	}
+
+	beg[0]=first;
+	end[0]=last+1;
+
+	while (i>=0)
+	{
+		L=beg[i];
+		R=end[i]-1;
+
+		if (L<R)
+		{
+			swap=arr[L];
+			while (L<R)
+			{
+				while ((isExcess(arcs[arr[R]].flow - arcs[swap].flow)>=0) && (L<R)) //((arr[R]->flow >= swap->flow) && (L<R))
+					R--;
+
+				if (L<R)
+				{
+					arr[L]=arr[R];
+					L++;
+				}
+
+				while ((isExcess(arcs[arr[L]].flow - arcs[swap].flow) <= 0) && (L<R)) //((arr[L]->flow <= swap->flow) && (L<R))
+					L++;
+
+				if (L<R)
+				{
+					arr[R]=arr[L];
+					R--;
+				}
+			}
+
+			arr[L] = swap;
+
+			beg[i+1] = L+1;
+			end[i+1] = end[i];
+			end[i++] = L;
+
+			if ((end[i]-beg[i]) > (end[i-1]-beg[i-1]))
+			{
+				temp=beg[i];
+				beg[i]=beg[i-1];
+				beg[i-1]=temp;
+				temp=end[i];
+				end[i]=end[i-1];
+				end[i-1]=temp;
+			}
+		}
+		else
+		{
+			i--;
+		}
+	}
+}
+
+static __inline void sort (HpfContext *ctx, Node * current)
+{
+/*************************************************************************
+sort
+*************************************************************************/
+	if (current->numOutOfTree > 1)
+	{
+		quickSort (ctx, outOfTreeArcs(ctx, (uint) (current - ctx->nodesList)), 0, (current->numOutOfTree-1));
+	}
+}
+
+static __inline void minisort (HpfContext *ctx, Node *current)
+{
+/*************************************************************************
+minisort
+*************************************************************************/
+	uint *outOfTree = outOfTreeArcs(ctx, (uint) (current - ctx->nodesList));
+	uint temp = outOfTree[current->nextArc];
+	uint i, size = current->numOutOfTree;/*, tempflow = temp->flow;*/
+	Capacity tempflow = ctx->arcList[temp].flow;
+
+	for(i=current->nextArc+1; ((i<size) && (isExcess(tempflow - ctx->arcList[outOfTree[i]].flow) < 0)); ++i)
+	{
+		outOfTree[i-1] = outOfTree[i];
+	}
+	outOfTree[i-1] = temp;
+}
+
+
+// static /*ullint*/double checkOptimality (const uint gap)
+// {
+// /*************************************************************************
+// checkOptimality
+// *************************************************************************/
+// 	uint i, check = 1;
+// 	/*ullint*/double mincut = 0;
+// 	/*llint*/ double *excess = NULL;
+//
+// 	Arc *tempArc;
+//
+// 	excess = (/*llint*/double *) malloc (numNodes * sizeof (double/*llint*/));
+// 	if (!excess)
+// 	{
+// 		printf("Out of memory\n");
+// 		exit(0);
+// 	}
+//
+// 	// Pushing depicits from all sink adjacent nodes to the sink
+// 	for (i=0; i<nodesList[sink].numOutOfTree; ++i)
+// 	{
+// 		tempArc = nodesList[sink].outOfTree[i];
+// 		if (isExcess(tempArc->from->excess) < 0)
+// 		{
+// 			if (isExcess((tempArc->from->excess + /*(int)*/ tempArc->flow))  < 0)
+// 			{
+// 				// Excess is high enough to saturate the arc => Flow on residual arc is zeroed
+// 				tempArc->from->excess += /*(int)*/ tempArc->flow;
+// 				tempArc->flow = 0;
+// 			}
+// 			else
+// 				// Excess is NOT high enough to saturate the arc => Excess is zeroed
+// 			{
+// 				tempArc->flow = /*(uint)*/ (tempArc->from->excess + /*(int)*/ tempArc->flow);
+// 				tempArc->from->excess = 0;
+// 			}
+// 		}
+// 	}
+//
+// 	for (i=0; i<numNodes; ++i)
+// 	{
+// 		excess[i] = 0;
+// 	}
+//
+// 	for (i=0; i<numArcs; ++i)
+// 	{
+// 		if ((arcList[i].from->label >= gap) && (arcList[i].to->label < gap))
+// 		{
+// 			mincut += arcList[i].capacity;
+// 		}
+//
+// 		if ((isExcess(arcList[i].flow - arcList[i].capacity)>0) || (isExcess(arcList[i].flow) < 0))
+// 		{
+// 			check = 0;
+// 			printf("Warning - Capacity constraint violated on arc (%d, %d). Flow = %lf, capacity = %lf\n",
+// 				   arcList[i].from->number,
+// 				   arcList[i].to->number,
+// 				   arcList[i].flow,
+// 				   arcList[i].capacity);
+// 		}
+// 		excess[arcList[i].from->number - 1] -= arcList[i].flow;
+// 		excess[arcList[i].to->number - 1] += arcList[i].flow;
+// 	}
+//
+// 	for (i=0; i<numNodes; i++)
+// 	{
+// 		if ((i != (source)) && (i != (sink)))
+// 		{
+// 			if (isExcess(excess[i]))
+// 			{
+// 				check = 0;
+// 				printf ("Warning - Flow balance constraint violated in node %d. Excess = %lf\n",
+// 						i+1,
+// 						excess[i]);
+// 			}
+// 		}
+// 	}
+//
+// 	check = 1;
+//
+// 	if (isExcess(excess[sink] - mincut) != 0)//(excess[sink] != mincut)
+// 	{
+// 		check = 0;
+// 		printf("Warning - Flow is not optimal - max flow does not equal min cut!\n");
+// 	}
+//
+// // 	if (check)
+// // 	{
+// // 		printf ("Solution checks as optimal. \t Max Flow: \t %lld\n", mincut);
+// // 	}
+//
+// 	free (excess);
+// 	excess = NULL;
+// 	return mincut;
+// }
+
+// static void decompose (Node *excessNode, const uint source, uint *iteration)
+// {
+// /*************************************************************************
+// decompose
+// *************************************************************************/
+// 	Node *current = excessNode;
+// 	Arc *tempArc;
+// 	/*uint*/double bottleneck = excessNode->excess;
+//
+// 	// Find the bottleneck along a path to the source or on a cycle
+// 	for ( ;(current->number != source) && (current->visited < (*iteration)) /*&& (current->nextArc < current->numOutOfTree)*/; // Added by Cheng
+// 		 current = tempArc->from)
+// 	{
+// 		current->visited = (*iteration);
+// 		tempArc = current->outOfTree[current->nextArc];
+//
+// 		if (isExcess(tempArc->flow - bottleneck) < 0) //(tempArc->flow < bottleneck)
+// 		{
+// 			bottleneck = tempArc->flow;
+// 		}
+// 	}
+//
+// 	if (current->number == source) // the DFS reached the source
+// 	{
+// 		excessNode->excess -= bottleneck;
+// 		current = excessNode;
+//
+// 		// Push the excess all the way to the source
+// 		while (current->number != source)
+// 		{
+// 			tempArc = current->outOfTree[current->nextArc]; // Pick arc going out of node to push excess to
+// 			tempArc->flow -= bottleneck; // Push back bottleneck excess on this arc
+//
+// 			if (isFlow(tempArc->flow)) // If there is still flow on this arc do sort on this current node
+// 			{
+// 				minisort(current);
+// 			} else {
+// 				++ current->nextArc;
+// 			}
+//
+// 			current = tempArc->from;
+// 		}
+// 		return;
+// 	}
+//
+// 	++ (*iteration);
+//
+// 	// This part is temporarily added by Cheng Lu.
+// //	if (current->visited == (*iteration)-1)
+// 		bottleneck = current->outOfTree[current->nextArc]->flow;
+// /*	else{
+// 		current = excessNode;
+// 		bottleneck = excessNode->excess;
+// 	}*/
+//
+// 	while (current->visited < (*iteration)) //&& (current->nextArc < current->numOutOfTree)) // Added by Cheng
+// 	{
+// 		current->visited = (*iteration);
+// 		tempArc = current->outOfTree[current->nextArc];
+//
+// 		if (isExcess(tempArc->flow - bottleneck) < 0)//(tempArc->flow < bottleneck)
+// 		{
+// 			bottleneck = tempArc->flow;
+// 		}
+// 		current = tempArc->from;
+// 	}
+//
+// 	++ (*iteration);
+//
+// 	// This part is temporarily added by Cheng Lu.
+// /*	if (current->visited == (*iteration)-1)
+// 		;
+// 	else{
+// 		current = excessNode;
+// 	}*/
+//
+// 	while (current->visited < (*iteration)) //&& (current->nextArc < current->numOutOfTree)) // Added by Cheng
+// 	{
+// 		current->visited = (*iteration);
+//
+// 		tempArc = current->outOfTree[current->nextArc];
+// 		tempArc->flow -= bottleneck;
+//
+// 		if (isFlow(tempArc->flow))
+// 		{
+// 			minisort(current);
+// 			current = tempArc->from;
+// 		} else {
+// 			++ current->nextArc;
+// 			current = tempArc->from;
+// 		}
+// 	}
+// }
+
+// static void recoverFlow (const uint gap)
+// {
+// /*************************************************************************
+// recoverFlow
+// *************************************************************************/
+// 	uint iteration = 1;
+// 	uint i, j;
+// 	Arc *tempArc;
+// 	Node *tempNode;
+//
+// 	Node **nodePtrArray;
+//
+// 	if ((nodePtrArray = (Node **) malloc (numNodes * sizeof (Node *))) == NULL)
+// 	{
+// 		printf("Out of memory\n");
+// 		exit(0);
+// 	}
+//
+// 	for (i=0; i < numNodes ; i++)
+// 		nodePtrArray[i] = &nodesList[i];
+//
+// 	// Adding arcs FROM the Source to Source adjacent nodes.
+// 	for (i=0; i<nodesList[source].numOutOfTree; ++i)
+// 	{
+// 		tempArc = nodesList[source].outOfTree[i];
+// 		addOutOfTreeNode (tempArc->to, tempArc);
+// 	}
+//
+// 	// Zeroing excess on source and sink nodes
+// 	nodesList[source].excess = 0;
+// 	nodesList[sink].excess = 0;
+//
+// 	for (i=0; i<numNodes; ++i)
+// 	{
+// 		tempNode = &nodesList[i];
+//
+// 		if ((i == (source)) || (i == (sink)))
+// 		{
+// 			continue;
+// 		}
+//
+// 		if (tempNode->label >= gap) //tempNode is in SINK set
+// 		{
+// 			tempNode->nextArc = 0;
+// 			if ((tempNode->parent) && (isFlow(tempNode->arcToParent->flow)))
+// 			{
+// 				addOutOfTreeNode (tempNode->arcToParent->to, tempNode->arcToParent);
+// 			}
+//
+// 			for (j=0; j<tempNode->numOutOfTree; ++j)
+// 			{ // go over all sink-set-node's arcs and look for arc with NO flow
 // 				if (!isFlow(tempNode->outOfTree[j]->flow))
 // 				{	// Remove arc with no flow
 // 					-- tempNode->numOutOfTree;
@@ -1340,936 +2721,3444 @@ minisort
 // 	nodePtrArray = NULL;
 // }
 
-static void readGraphSuper(double * arcMatrix)
+static void allocateGraphSuper(HpfContext *ctx)
+/*************************************************************************
+allocateGraphSuper - Nodes, node breakpoints and numArcsSuper empty arcs
+of the super graph. Running out of memory unwinds the read, which frees
+what was allocated.
+*************************************************************************/
+{
+	// printf("OG #nodes %d #arcs %d\n", numNodesSuper, numArcsSuper);
+	if ((ctx->nodeListSuper = (NodeInfo *)malloc(ctx->numNodesSuper * sizeof(NodeInfo))) == NULL ||
+		(ctx->nodeBreakpoints = (double *)malloc(ctx->numNodesSuper * sizeof(double))) == NULL ||
+		(ctx->arcListSuper = (Arc *)malloc(ctx->numArcsSuper * sizeof(Arc))) == NULL)
+	{
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+
+	/* Initialization. A node that never joins the source set keeps an infinite
+	breakpoint, apart from the nodes that join it at the upper bound. */
+	for (int i = 0; i < ctx->numNodesSuper; ++i)
+	{
+		initializeNodeInfo(&ctx->nodeListSuper[i]);
+		ctx->nodeListSuper[i].originalIndex = i;
+        ctx->nodeBreakpoints[i] = INFINITY;
+	}
+
+    ctx->nodeBreakpoints[ctx->sourceSuper] = lambdaToDouble(ctx->LAMBDA_LOW);
+
+	for (int i = 0; i < ctx->numArcsSuper; ++i)
+	{
+		initializeArc(&ctx->arcListSuper[i]);
+	}
+
+	if (lambdaCompare(ctx->LAMBDA_LOW, ctx->LAMBDA_HIGH) == 0)
+	{
+		ctx->useParametricCut = 0;
+	}
+}
+
+static void setArcSuper(HpfContext *ctx, uint i, uint from, uint to, double constant, double multiplier)
+/*************************************************************************
+setArcSuper - Arc i of the super graph. A fractional or too large capacity
+in an integer capacity mode unwinds the read with HPF_ERROR_INVALID_INPUT.
+*************************************************************************/
+{
+#ifdef HPF_INTEGER_CAPACITY
+	if (!isIntegerCapacity(constant) || !isIntegerCapacity(multiplier))
+	{
+		printf("Arc %u has a fractional or too large capacity. The integer capacity modes require integer constants and multipliers.\n", i);
+		arenaRaise(&ctx->arena, HPF_ERROR_INVALID_INPUT);
+	}
+#endif
+	ctx->arcListSuper[i].constant = (Capacity) constant;
+	ctx->arcListSuper[i].multiplier = (Capacity) multiplier;
+	ctx->arcListSuper[i].from = from;
+	ctx->arcListSuper[i].to = to;
+
+	++ctx->nodeListSuper[from].numAdjacent;
+	++ctx->nodeListSuper[to].numAdjacent;
+}
+
+static void readGraphSuper(HpfContext *ctx, double * arcMatrix)
+/*************************************************************************
+readData
+*************************************************************************/
+{
+	allocateGraphSuper(ctx);
+	for (int i=0; i < ctx->numArcsSuper; ++i)
+	{
+		setArcSuper(ctx, i, (uint) arcMatrix[i * 4 + 0], (uint) arcMatrix[i * 4 + 1],
+			arcMatrix[i * 4 + 2], arcMatrix[i * 4 + 3]);
+	}
+}
+
+static void buildSuperIncidence(HpfContext *ctx)
+/*************************************************************************
+buildSuperIncidence - Index the arcs of the super graph by their endpoints:
+the arcs incident to node i, in either direction, are superIncidentArcs
+[superIncidenceOffsets[i] .. superIncidenceOffsets[i + 1] - 1]. Built after
+the arcs are sorted.
+*************************************************************************/
+{
+	uint i;
+	uint *next;
+
+	if ((ctx->superIncidenceOffsets = (uint *)calloc(ctx->numNodesSuper + 1, sizeof(uint))) == NULL ||
+		(ctx->superIncidentArcs = (uint *)malloc(2 * (size_t) ctx->numArcsSuper * sizeof(uint))) == NULL ||
+		(next = (uint *)malloc(ctx->numNodesSuper * sizeof(uint))) == NULL)
+	{
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+
+	for (i = 0; i < ctx->numNodesSuper; ++i)
+	{
+		ctx->superIncidenceOffsets[i + 1] = ctx->superIncidenceOffsets[i] + ctx->nodeListSuper[i].numAdjacent;
+		next[i] = ctx->superIncidenceOffsets[i];
+	}
+
+	for (i = 0; i < ctx->numArcsSuper; ++i)
+	{
+		ctx->superIncidentArcs[next[ctx->arcListSuper[i].from]++] = i;
+		ctx->superIncidentArcs[next[ctx->arcListSuper[i].to]++] = i;
+	}
+
+	free(next);
+}
+
+static uint findWeakNodeShared (HpfContext *ctx, const uint strongNode, const uint weakLabel,
+	uint *weakNode, uint *numArcScans)
+{
+/*************************************************************************
+findWeakNodeShared - findWeakNode for a batch of roots scanned in
+parallel. The labels of other trees are read atomically, their threads
+may relabel them.
+*************************************************************************/
+	Node *strong = &ctx->nodesList[strongNode];
+	const uint *labels = ctx->labels;
+	uint i, size, out;
+	uint *outOfTree = outOfTreeArcs(ctx, strongNode);
+	Arc *arc;
+
+	size = strong->numOutOfTree;
+
+	for (i=strong->nextArc; i<size; ++i)
+	{
+		++ (*numArcScans);
+		out = outOfTree[i];
+		arc = &ctx->arcList[out];
+		if (__atomic_load_n(&labels[arc->to], __ATOMIC_RELAXED) == weakLabel)
+		{
+			(*weakNode) = arc->to;
+		}
+		else if (__atomic_load_n(&labels[arc->from], __ATOMIC_RELAXED) == weakLabel)
+		{
+			(*weakNode) = arc->from;
+		}
+		else
+		{
+			continue;
+		}
+		strong->nextArc = i;
+		-- strong->numOutOfTree;
+		outOfTree[i] = outOfTree[strong->numOutOfTree];
+		return (out);
+	}
+
+	strong->nextArc = strong->numOutOfTree;
+
+	return NONE;
+}
+
+static void checkChildrenShared (HpfContext *ctx, const uint curNode, uint *numRelabels)
+{
+/*************************************************************************
+checkChildrenShared - checkChildren for a batch of roots scanned in
+parallel, with atomic label counts
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	Node *current = &nodes[curNode];
+	uint *labels = ctx->labels;
+	uint label = labels[curNode];
+
+	for ( ; (current->nextScan != NONE); current->nextScan = nodes[current->nextScan].next)
+	{
+		if (labels[current->nextScan] == label)
+		{
+			return;
+		}
+	}
+
+	__atomic_fetch_sub(&ctx->labelCount[label], 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&labels[curNode], label + 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&ctx->labelCount[label + 1], 1, __ATOMIC_RELAXED);
+
+	++ (*numRelabels);
+
+	current->nextArc = 0;
+}
+
+static void scanRoot (RootBatchThread *thread, const uint root)
+{
+/*************************************************************************
+scanRoot - The search of processRoot for root of the batch, without the
+merge: records the arc to the first weak node found, or NONE if the tree
+was relabeled. Only the tree of the root is written, so the roots of a
+batch can be scanned at the same time.
+*************************************************************************/
+	RootBatch *batch = thread->batch;
+	HpfContext *ctx = batch->ctx;
+	Node *nodes = ctx->nodesList;
+	const uint strongRoot = batch->roots[root];
+	uint temp, strongNode = strongRoot, weakNode;
+	uint out;
+
+	batch->arcs[root] = NONE;
+	nodes[strongRoot].nextScan = nodes[strongRoot].childList;
+
+	if ((out = findWeakNodeShared (ctx, strongRoot, batch->weakLabel, &weakNode, &thread->numArcScans)) == NONE)
+	{
+		checkChildrenShared (ctx, strongRoot, &thread->numRelabels);
+
+		while (strongNode != NONE && out == NONE)
+		{
+			while (nodes[strongNode].nextScan != NONE)
+			{
+				temp = nodes[strongNode].nextScan;
+				nodes[strongNode].nextScan = nodes[temp].next;
+				strongNode = temp;
+				nodes[strongNode].nextScan = nodes[strongNode].childList;
+
+				if ((out = findWeakNodeShared (ctx, strongNode, batch->weakLabel, &weakNode, &thread->numArcScans)) != NONE)
+				{
+					break;
+				}
+
+				checkChildrenShared (ctx, strongNode, &thread->numRelabels);
+			}
+
+			if (out == NONE && (strongNode = nodes[strongNode].parent) != NONE)
+			{
+				checkChildrenShared (ctx, strongNode, &thread->numRelabels);
+			}
+		}
+	}
+
+	if (out != NONE)
+	{
+		batch->arcs[root] = out;
+		batch->strongNodes[root] = strongNode;
+		batch->weakNodes[root] = weakNode;
+	}
+}
+
+static void scanRoots (RootBatchThread *thread)
+{
+/*************************************************************************
+scanRoots - Scan roots of the batch until all are taken
+*************************************************************************/
+	RootBatch *batch = thread->batch;
+	uint root;
+
+	while ((root = __atomic_fetch_add(&batch->nextRoot, 1, __ATOMIC_RELAXED)) < batch->numRoots)
+	{
+		scanRoot (thread, root);
+	}
+}
+
+static void batchBarrier (RootBatch *batch)
+{
+/*************************************************************************
+batchBarrier - Wait until all threads of the run arrive
+*************************************************************************/
+	uint generation;
+
+	pthread_mutex_lock(&batch->lock);
+	generation = batch->generation;
+	if (++batch->numWaiting == batch->numThreads)
+	{
+		batch->numWaiting = 0;
+		++batch->generation;
+		pthread_cond_broadcast(&batch->arrived);
+	}
+	else
+	{
+		while (generation == batch->generation)
+		{
+			pthread_cond_wait(&batch->arrived, &batch->lock);
+		}
+	}
+	pthread_mutex_unlock(&batch->lock);
+}
+
+static void * scanBatches (void *arg)
+{
+/*************************************************************************
+scanBatches - Body of the helper threads of a parallel pseudoflow run
+*************************************************************************/
+	RootBatchThread *thread = (RootBatchThread *) arg;
+	RootBatch *batch = thread->batch;
+
+	while (1)
+	{
+		batchBarrier (batch);
+		if (batch->done)
+		{
+			break;
+		}
+		scanRoots (thread);
+		batchBarrier (batch);
+	}
+	return NULL;
+}
+
+static void parallelPseudoflowPhase1 (HpfContext *ctx, uint numThreads)
+{
+/*************************************************************************
+parallelPseudoflowPhase1 - pseudoflowPhase1 on numThreads threads. The
+strong roots of the highest label are taken in batches, and the threads
+scan their trees at the same time: the trees are disjoint, and their nodes
+have labels of at least the label of the batch, so the weak nodes of the
+batch are in none of them and keep their labels. The calling thread then
+merges and pushes the roots that found a weak node, in the order of the
+batch, as processRoot would have. Merges and pushes only change the trees
+of the weak nodes, so the result of each scan stays valid and the run does
+not depend on the timing of the threads, or on their number if not all of
+them can be created.
+*************************************************************************/
+	Node *nodes = ctx->nodesList;
+	RootBatch batch;
+	uint maxRoots = numThreads * ROOT_BATCH_SIZE;
+	uint i, root, label;
+
+	batch.ctx = ctx;
+	batch.roots = (uint *)arenaAlloc(&ctx->arena, maxRoots * sizeof(uint));
+	batch.arcs = (uint *)arenaAlloc(&ctx->arena, maxRoots * sizeof(uint));
+	batch.strongNodes = (uint *)arenaAlloc(&ctx->arena, maxRoots * sizeof(uint));
+	batch.weakNodes = (uint *)arenaAlloc(&ctx->arena, maxRoots * sizeof(uint));
+	batch.threads = (RootBatchThread *)arenaAlloc(&ctx->arena, numThreads * sizeof(RootBatchThread));
+	batch.threadIds = (pthread_t *)arenaAlloc(&ctx->arena, numThreads * sizeof(pthread_t));
+	batch.numThreads = numThreads;
+	batch.done = 0;
+	batch.numWaiting = 0;
+	batch.generation = 0;
+	pthread_mutex_init(&batch.lock, NULL);
+	pthread_cond_init(&batch.arrived, NULL);
+
+	/* the threads wait for the lock at their first barrier, so a run with
+	fewer threads than could be created is set up before any arrives */
+	pthread_mutex_lock(&batch.lock);
+	for (i = 0; i < numThreads; ++i)
+	{
+		batch.threads[i].batch = &batch;
+		batch.threads[i].numArcScans = 0;
+		batch.threads[i].numRelabels = 0;
+		if (i > 0 && pthread_create(&batch.threadIds[i], NULL, scanBatches, &batch.threads[i]) != 0)
+		{
+			batch.numThreads = i;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&batch.lock);
+
+	while ((root = getHighestStrongRoot (ctx)) != NONE)
+	{
+		label = ctx->highestStrongLabel;
+		if (ctx->strongRoots[label].start == NONE)
+		{
+			processRoot (ctx, root);
+			continue;
+		}
+
+		batch.roots[0] = root;
+		batch.numRoots = 1;
+		while (batch.numRoots < maxRoots && ctx->strongRoots[label].start != NONE)
+		{
+			root = ctx->strongRoots[label].start;
+			ctx->strongRoots[label].start = nodes[root].next;
+			nodes[root].next = NONE;
+			batch.roots[batch.numRoots++] = root;
+		}
+		batch.weakLabel = label - 1;
+		batch.nextRoot = 0;
+
+		if (batch.numRoots >= ROOT_BATCH_MIN)
+		{
+			batchBarrier (&batch);
+			scanRoots (&batch.threads[0]);
+			batchBarrier (&batch);
+		}
+		else
+		{
+			scanRoots (&batch.threads[0]);
+		}
+
+		for (i = 0; i < batch.numRoots; ++i)
+		{
+			root = batch.roots[i];
+			if (batch.arcs[i] != NONE)
+			{
+				merge (ctx, batch.weakNodes[i], batch.strongNodes[i], batch.arcs[i]);
+				pushExcess (ctx, root);
+			}
+			else
+			{
+				addToStrongBucket (nodes, root, &ctx->strongRoots[ctx->labels[root]]);
+				if (ctx->labels[root] > ctx->highestStrongLabel)
+				{
+					ctx->highestStrongLabel = ctx->labels[root];
+				}
+			}
+		}
+	}
+
+	batch.done = 1;
+	batchBarrier (&batch);
+	for (i = 0; i < batch.numThreads; ++i)
+	{
+		if (i > 0)
+		{
+			pthread_join(batch.threadIds[i], NULL);
+		}
+		ctx->numArcScans += batch.threads[i].numArcScans;
+		ctx->numRelabels += batch.threads[i].numRelabels;
+	}
+	pthread_mutex_destroy(&batch.lock);
+	pthread_cond_destroy(&batch.arrived);
+}
+
+static void pseudoflowPhase1 (HpfContext *ctx)
+{
+/*************************************************************************
+pseudoflowPhase1 - Process the strong roots, on the threads of the context
+if the problem has at least parallelPseudoflowNodes nodes
+*************************************************************************/
+	uint strongRoot;
+	uint numThreads = contextThreads(ctx);
+
+	if (ctx->parallelPseudoflowNodes > 0 && ctx->numNodes >= ctx->parallelPseudoflowNodes && numThreads > 1)
+	{
+		parallelPseudoflowPhase1 (ctx, numThreads);
+		return;
+	}
+
+	while ((strongRoot = getHighestStrongRoot (ctx)) != NONE)
+	{
+		processRoot (ctx, strongRoot);
+	}
+}
+
+static void prepareOutput (HpfContext *ctx, int * numBreakpoints, double ** cuts, double ** breakpoints, int stats[5] )
+{
+/*************************************************************************
+printOutput
+*************************************************************************/
+	Breakpoint *currentBreakpoint;
+	int i;
+	int j;
+
+	stats[0] = ctx->numArcScans;
+	stats[1] = ctx->numMergers;
+	stats[2] = ctx->numPushes;
+	stats[3] = ctx->numRelabels;
+	stats[4] = ctx->numGaps;
+
+	/* count num breakpoints */
+	*numBreakpoints = 0;
+	currentBreakpoint = ctx->firstBreakpoint;
+	while (currentBreakpoint != NULL)
+	{
+		if (!currentBreakpoint->placeholder)
+		{
+			++*numBreakpoints;
+		}
+		currentBreakpoint = currentBreakpoint->next;
+	}
+
+	double* breakpointsPointer;
+	double* cutsPointer;
+	/* both outputs or none, running out of memory unwinds the solve */
+	if ((breakpointsPointer = (double *)malloc((*numBreakpoints > 0 ? *numBreakpoints : 1) * sizeof(double))) == NULL ||
+		(cutsPointer = (double *)malloc( ctx->numNodesSuper * sizeof(double))) == NULL)
+	{
+		free(breakpointsPointer);
+		*numBreakpoints = 0;
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+
+	currentBreakpoint = ctx->firstBreakpoint;
+	for (i = 0; i < *numBreakpoints; currentBreakpoint = currentBreakpoint->next)
+	{
+		if (!currentBreakpoint->placeholder)
+		{
+			breakpointsPointer[i++] = (double) currentBreakpoint->lambdaValue;
+		}
+	}
+
+	*breakpoints = breakpointsPointer;
+
+	/* print values nodes*/
+    for (j = 0; j < ctx->numNodesSuper; j++)
+    {
+        cutsPointer[j] = ctx->nodeBreakpoints[j];
+    }
+
+	*cuts = cutsPointer;
+}
+
+
+
+static Capacity arcCapacity(const HpfContext *ctx, const Arc *old, Lambda lambda)
+/*************************************************************************
+arcCapacity - capacity of an arc of the super graph at lambda
+*************************************************************************/
+{
+    Capacity capacity = scaledCapacity(ctx, old->constant, old->multiplier, lambda);
+
+    if (capacity < 0)
+    {
+        if (ctx->roundNegativeCapacity)
+        {
+            capacity = 0;
+        }
+        else
+        {
+            printf("Negative capacity for lambda equal to %lf. Set roundNegativeCapacity to 1 if the value should be rounded to 0.\n", lambdaToDouble(lambda));
+            exit(0);
+        }
+    }
+    return capacity;
+}
+
+static void copyArcNew(HpfContext *ctx, CutProblem *problem, uint newIndexFrom, uint newIndexTo,
+	Arc *old, Arc *new, Lambda lambda)
+/*************************************************************************
+copyArcNew - copy basic info arc and point to new nodes
+*************************************************************************/
+{
+	initializeArc(new);
+	new->capacity = arcCapacity(ctx, old, lambda);
+	if (ctx->undirected)
+	{
+		new->capacity *= 2;
+	}
+
+	/* set start and end node */
+	new->from = newIndexFrom;
+	new->to = newIndexTo;
+
+	/* update degree nodes*/
+	++ problem->nodeInfo[newIndexFrom].numAdjacent;
+	++ problem->nodeInfo[newIndexTo].numAdjacent;
+}
+
+static void destroyProblem(HpfContext *ctx, CutProblem *problem)
+/*************************************************************************
+destroyProblem - Return the graph of a solved problem to the pool of the
+context. The source set stays with the problem.
+*************************************************************************/
+{
+	poolRelease(ctx, problem->nodeList);
+	poolRelease(ctx, problem->nodeInfo);
+	poolRelease(ctx, problem->sourceCapacity);
+	poolRelease(ctx, problem->sinkCapacity);
+	poolRelease(ctx, problem->arcList);
+	problem->sourceCapacity = NULL;
+	problem->sinkCapacity = NULL;
+	problem->nodeList = NULL;
+	problem->nodeInfo = NULL;
+	problem->arcList = NULL;
+}
+
+static CutProblem * createProblem(HpfContext *ctx)
+/*************************************************************************
+createProblem - Allocate an empty problem with one reference, held by
+the caller
+*************************************************************************/
+{
+	CutProblem *problem = (CutProblem *)trackedMalloc(ctx, sizeof(CutProblem));
+
+	memset(problem, 0, sizeof(CutProblem));
+	problem->references = 1;
+	problem->lowEntry = NONE;
+	problem->highEntry = NONE;
+	problem->entry = NONE;
+	return problem;
+}
+
+static SetWord * allocateSourceSet(HpfContext *ctx, const CutProblem *graphProblem, CutProblem *problem)
+/*************************************************************************
+allocateSourceSet - Empty source set indicator of problem, solved on the
+graph of graphProblem: one bit per node of the super graph for a graph of
+all nodes, one per free node for a contracted graph
+*************************************************************************/
+{
+	uint numBits = graphProblem->lowEntry == NONE ? ctx->numNodesSuper : graphProblem->numNodesInList - 2;
+	size_t size;
+
+	problem->lowEntry = graphProblem->lowEntry;
+	problem->highEntry = graphProblem->highEntry;
+	problem->setWords = (uint) sourceSetWords(numBits);
+	size = problem->setWords * sizeof(SetWord);
+	problem->optimalSourceSetIndicator = (SetWord *)trackedMalloc(ctx, size);
+	memset(problem->optimalSourceSetIndicator, 0, size);
+	return problem->optimalSourceSetIndicator;
+}
+
+static void freeSourceSet(HpfContext *ctx, CutProblem *problem)
+/*************************************************************************
+freeSourceSet - Drop the source set indicator of a problem. A problem in
+the chain still answers inSourceSetOf.
+*************************************************************************/
+{
+	trackedFree(ctx, problem->optimalSourceSetIndicator, problem->setWords * sizeof(SetWord));
+	problem->optimalSourceSetIndicator = NULL;
+	problem->setWords = 0;
+}
+
+static void releaseProblem(HpfContext *ctx, CutProblem *problem)
+/*************************************************************************
+releaseProblem - Drop a reference to a problem, and free its source set
+and warm start arcs with the last one
+*************************************************************************/
+{
+	uint references;
+
+	lockShared(ctx);
+	references = --problem->references;
+	unlockShared(ctx);
+	if (references > 0)
+	{
+		return;
+	}
+
+	freeSourceSet(ctx, problem);
+	trackedFree(ctx, problem->saturatedArcs, (ctx->numArcsSuper + 7) / 8);
+	trackedFree(ctx, problem, sizeof(CutProblem));
+}
+
+static void initializeDerivedProblem(CutProblem *problem, const Lambda lambdaValue)
+/*************************************************************************
+initializeDerivedProblem - Problem without a graph of its own, solved by
+the run on the graph of another problem
+*************************************************************************/
+{
+	problem->numNodesInList = 0;
+	problem->numArcs = 0;
+	problem->solved = 0;
+	problem->lambdaValue = lambdaValue;
+	problem->arcList = NULL;
+	problem->nodeList = NULL;
+	problem->nodeInfo = NULL;
+	problem->sourceCapacity = NULL;
+	problem->sinkCapacity = NULL;
+	problem->cutValue = 0;
+	problem->lowEntry = NONE;
+	problem->highEntry = NONE;
+	problem->optimalSourceSetIndicator = NULL;
+	problem->setWords = 0;
+	problem->warmStartArcs = NULL;
+	problem->saturatedArcs = NULL;
+	problem->sourceSetSize = 0;
+	problem->cutConstant = 0;
+	problem->cutMultiplier = 0;
+}
+
+static __inline int isFreeNode(HpfContext *ctx, const uint node, const CutProblem *problem)
+/*************************************************************************
+isFreeNode - Whether a super node is free in the graph of problem, which
+is contracted between the chain entries lowEntry and highEntry
+*************************************************************************/
+{
+	return node != ctx->sourceSuper && node != ctx->sinkSuper
+		&& (problem->lowEntry == NONE || joinEntry(ctx, node) == problem->highEntry);
+}
+
+static __inline uint contractedIndex(HpfContext *ctx, const uint node, const CutProblem *problem)
+/*************************************************************************
+contractedIndex - Index of a super node in a contracted problem: 0 for the
+nodes that join the source set by lowEntry, 1 for those that join it after
+highEntry, nodeMap for the free nodes in between
+*************************************************************************/
+{
+	uint entry;
+
+	if (node == ctx->sourceSuper)
+	{
+		return 0;
+	}
+	if (node == ctx->sinkSuper)
+	{
+		return 1;
+	}
+	if (problem->lowEntry == NONE)
+	{
+		return ctx->nodeMap[node];
+	}
+	entry = joinEntry(ctx, node);
+	if (entry == problem->highEntry)
+	{
+		return ctx->nodeMap[node];
+	}
+	return joinsBy(ctx, entry, problem->lowEntry) ? 0 : 1;
+}
+
+static int cmpUint(const void *a, const void *b)
+{
+	uint x = *(const uint *)a;
+	uint y = *(const uint *)b;
+	return (x > y) - (x < y);
+}
+
+static void * reduceTerminalArcs(void *arg)
+/*************************************************************************
+reduceTerminalArcs - First phase of a parallel arc pass. For each free
+node of the range of the thread, sum the capacities of its source and sink
+arcs, walking its incident arcs in the order of the super graph as the
+serial pass does. Counts the internal arcs of the node as well.
+*************************************************************************/
+{
+	ArcPassThread *thread = (ArcPassThread *) arg;
+	ArcPass *pass = thread->pass;
+	HpfContext *ctx = pass->ctx;
+	CutProblem *problem = pass->problem;
+	uint numFreeNodes = problem->numNodesInList - 2;
+	uint first = 2 + (uint) ((unsigned long long) numFreeNodes * thread->index / pass->numThreads);
+	uint last = 2 + (uint) ((unsigned long long) numFreeNodes * (thread->index + 1) / pass->numThreads);
+	uint i, j, node, newIndexFrom, newIndexTo;
+	const Arc *superArc;
+
+	for (i = first; i < last; ++i)
+	{
+		node = problem->nodeInfo[i].originalIndex;
+		for (j = ctx->superIncidenceOffsets[node]; j < ctx->superIncidenceOffsets[node + 1]; ++j)
+		{
+			superArc = &ctx->arcListSuper[ctx->superIncidentArcs[j]];
+			newIndexFrom = contractedIndex(ctx, superArc->from, problem);
+			newIndexTo = contractedIndex(ctx, superArc->to, problem);
+			orientEdge(ctx, superArc, &newIndexFrom, &newIndexTo);
+
+			if (newIndexFrom == newIndexTo || newIndexTo == 0 || newIndexFrom == 1)
+			{
+			}
+			else if (newIndexFrom == 0)
+			{
+				problem->sourceCapacity[i] += arcCapacity(ctx, superArc, problem->lambdaValue);
+			}
+			else if (newIndexTo == 1)
+			{
+				problem->sinkCapacity[i] += arcCapacity(ctx, superArc, problem->lambdaValue);
+			}
+			else
+			{
+				++problem->nodeInfo[i].numAdjacent;
+			}
+		}
+	}
+	return NULL;
+}
+
+static void * copyArcRange(void *arg, int write)
+/*************************************************************************
+copyArcRange - Walk the arcs of the range of the thread in the order of
+the serial pass and count the internal arcs among them, or write them
+behind the offset of the thread
+*************************************************************************/
+{
+	ArcPassThread *thread = (ArcPassThread *) arg;
+	ArcPass *pass = thread->pass;
+	HpfContext *ctx = pass->ctx;
+	CutProblem *problem = pass->problem;
+	uint first = (uint) ((unsigned long long) pass->numArcsProblem * thread->index / pass->numThreads);
+	uint last = (uint) ((unsigned long long) pass->numArcsProblem * (thread->index + 1) / pass->numThreads);
+	uint i, j, newIndexFrom, newIndexTo;
+	uint currentArc = write ? pass->slotOffsets[thread->index] : 0;
+	const Arc *superArc;
+	Arc *arc;
+
+	for (j = first; j < last; ++j)
+	{
+		i = pass->arcIndices == NULL ? j : pass->arcIndices[j];
+		superArc = &ctx->arcListSuper[i];
+		newIndexFrom = contractedIndex(ctx, superArc->from, problem);
+		newIndexTo = contractedIndex(ctx, superArc->to, problem);
+
+		if (newIndexFrom == newIndexTo || newIndexFrom <= 1 || newIndexTo <= 1)
+		{
+			continue;
+		}
+
+		if (write)
+		{
+			arc = &problem->arcList[currentArc];
+			initializeArc(arc);
+			arc->from = newIndexFrom;
+			arc->to = newIndexTo;
+			arc->capacity = arcCapacity(ctx, superArc, problem->lambdaValue);
+			if (ctx->undirected)
+			{
+				arc->capacity *= 2;
+			}
+			arc->superArc = i;
+		}
+		++currentArc;
+	}
+
+	if (!write)
+	{
+		pass->slotOffsets[thread->index + 1] = currentArc;
+	}
+	return NULL;
+}
+
+static void * countArcSlots(void *arg)
+{
+	return copyArcRange(arg, 0);
+}
+
+static void * writeArcSlots(void *arg)
+{
+	return copyArcRange(arg, 1);
+}
+
+static void runArcPhase(ArcPass *pass, void * (*phase)(void *))
+/*************************************************************************
+runArcPhase - Run a phase of a parallel arc pass on all of its threads.
+The calling thread takes the first range, and the ranges of the threads
+that could not be created.
+*************************************************************************/
+{
+	ArcPassThread *threads = pass->threads;
+	pthread_t *ids = pass->threadIds;
+	uint i, numStarted;
+
+	for (i = 0; i < pass->numThreads; ++i)
+	{
+		threads[i].pass = pass;
+		threads[i].index = i;
+	}
+	for (numStarted = 1; numStarted < pass->numThreads; ++numStarted)
+	{
+		if (pthread_create(&ids[numStarted], NULL, phase, &threads[numStarted]) != 0)
+		{
+			break;
+		}
+	}
+	phase(&threads[0]);
+	for (i = numStarted; i < pass->numThreads; ++i)
+	{
+		phase(&threads[i]);
+	}
+	for (i = 1; i < numStarted; ++i)
+	{
+		pthread_join(ids[i], NULL);
+	}
+}
+
+static void parallelArcPass(HpfContext *ctx, CutProblem *problem, const uint *arcIndices,
+	uint numArcsProblem, uint numThreads)
+/*************************************************************************
+parallelArcPass - The arc pass of initializeContractedProblem on several
+threads, with the same arcs, capacities and degrees as the serial pass:
+the terminal capacities of each free node are reduced in the order of the
+super graph, the threads count the internal arcs of their range, and a
+prefix sum gives the offset at which each writes them.
+*************************************************************************/
+{
+	ArcPass pass;
+	uint i;
+
+	pass.ctx = ctx;
+	pass.problem = problem;
+	pass.arcIndices = arcIndices;
+	pass.numArcsProblem = numArcsProblem;
+	pass.numThreads = numThreads;
+	pass.slotOffsets = (uint *)arenaAlloc(&ctx->arena, (numThreads + 1) * sizeof(uint));
+	pass.threads = (ArcPassThread *)arenaAlloc(&ctx->arena, numThreads * sizeof(ArcPassThread));
+	pass.threadIds = (pthread_t *)arenaAlloc(&ctx->arena, numThreads * sizeof(pthread_t));
+
+	runArcPhase(&pass, reduceTerminalArcs);
+
+	pass.slotOffsets[0] = 0;
+	runArcPhase(&pass, countArcSlots);
+	for (i = 0; i < numThreads; ++i)
+	{
+		pass.slotOffsets[i + 1] += pass.slotOffsets[i];
+	}
+	runArcPhase(&pass, writeArcSlots);
+
+	problem->numArcs = pass.slotOffsets[numThreads];
+}
+
+static uint arcPassThreads(const HpfContext *ctx, uint numArcsProblem)
+/*************************************************************************
+arcPassThreads - Threads for the arc pass of a problem with numArcsProblem
+arcs: those of the context, at most one per ARC_PASS_CHUNK arcs. The
+parallel pass reduces the terminal arcs through the super incidence lists,
+which a single cut does not build, so it copies its arcs alone.
+*************************************************************************/
+{
+	uint numThreads = contextThreads(ctx);
+
+	if (ctx->superIncidenceOffsets == NULL)
+	{
+		return 1;
+	}
+
+	if (numThreads > numArcsProblem / ARC_PASS_CHUNK)
+	{
+		numThreads = numArcsProblem / ARC_PASS_CHUNK;
+	}
+	return numThreads > 0 ? numThreads : 1;
+}
+
+static void initializeContractedProblem(HpfContext *ctx, CutProblem *problem, const uint *candidates,
+	uint numCandidates, const Lambda lambdaValue, uint lowEntry, uint highEntry)
+/*************************************************************************
+initializeContractedProblem - Setup problems for parametric cut. The
+nodes that join the source set by the chain entry lowEntry are contracted
+into the source, those that join it after highEntry into the sink. The free
+nodes are taken from candidates, a superset in increasing order, and only
+their arcs are visited. Without candidates, all nodes are free and the
+entries are NONE. The arcs between free nodes are copied in the order of
+the super graph, the capacities of the terminal arcs are summed per free
+node. Large problems are copied by several threads (see parallelArcPass).
+The nodes and arcs live in buffers of the pool of the context, sized to
+the problem, until destroyProblem.
+*************************************************************************/
+{
+	uint i, j, node, other, newIndexTo, newIndexFrom;
+	uint currentNode = 2;
+    uint currentArc = 0;
+    uint numArcsProblem;
+    uint numThreads;
+    uint *arcIndices = NULL;
+    const Arc *superArc;
+    ArenaMark scratch;
+
+	/* set cut parameters */
+	problem->cutValue = 0;
+
+	/* set solved indicator */
+	problem->solved = 0;
+
+	/* initialize optimal cut */
+	problem->optimalSourceSetIndicator = NULL;
+
+	/* cold start unless the caller passes the arcs saturated by a parent solve */
+	problem->warmStartArcs = NULL;
+	problem->saturatedArcs = NULL;
+
+	/* cut function, set once the problem is solved */
+	problem->sourceSetSize = 0;
+	problem->cutConstant = 0;
+	problem->cutMultiplier = 0;
+
+	/* initialize new lambda value */
+	problem->lambdaValue = lambdaValue;
+	problem->lowEntry = lowEntry;
+	problem->highEntry = highEntry;
+	problem->numNodesInList = 2;
+
+	/* allocateSpace for nodeMap */
+	if (ctx->nodeMap==NULL && (ctx->nodeMap = (int *)malloc(ctx->numNodesSuper* sizeof(int))) == NULL)
+	{
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+
+	/* count the free nodes */
+	if (candidates == NULL)
+	{
+		numCandidates = ctx->numNodesSuper;
+	}
+    for (i = 0; i < numCandidates; i++)
+	{
+		node = candidates == NULL ? i : candidates[i];
+		if (isFreeNode(ctx, node, problem))
+		{
+			++currentNode;
+		}
+	}
+	problem->numNodesInList = currentNode;
+
+	/* allocate space for the node sets*/
+	problem->nodeList = (Node *)poolAlloc(ctx, problem->numNodesInList * sizeof(Node));
+	problem->nodeInfo = (NodeInfo *)poolAlloc(ctx, problem->numNodesInList * sizeof(NodeInfo));
+	problem->sourceCapacity = (Capacity *)poolAlloc(ctx, problem->numNodesInList * sizeof(Capacity));
+	problem->sinkCapacity = (Capacity *)poolAlloc(ctx, problem->numNodesInList * sizeof(Capacity));
+
+    // initialize nodes
+    for (i = 0; i < problem->numNodesInList; i++)
+    {
+        initializeNode(&problem->nodeList[i]);
+        initializeNodeInfo(&problem->nodeInfo[i]);
+        problem->sourceCapacity[i] = 0;
+        problem->sinkCapacity[i] = 0;
+    }
+     /* source is always first node */
+    problem->nodeInfo[0].originalIndex = -1; /* indicate artificial source node */
+    problem->nodeInfo[1].originalIndex = -2; /* indicate artificial sink node */
+
+	/* number the free nodes */
+	currentNode = 2;
+	for (i = 0; i < numCandidates && currentNode < problem->numNodesInList; i++)
+	{
+		node = candidates == NULL ? i : candidates[i];
+        if (isFreeNode(ctx, node, problem))
+        {
+			ctx->nodeMap[node] = currentNode;
+			problem->nodeInfo[currentNode].originalIndex = node;
+			++currentNode;
+		}
+	}
+
+
+	/* collect the arcs of the free nodes, each once: at its tail, or at its
+	head if the tail is contracted. Sorting keeps the order of the super graph. */
+	scratch = arenaMark(&ctx->arena);
+	numArcsProblem = ctx->numArcsSuper;
+	if (candidates != NULL)
+	{
+		numArcsProblem = 0;
+		for (i = 2; i < problem->numNodesInList; i++)
+		{
+			node = problem->nodeInfo[i].originalIndex;
+			numArcsProblem += ctx->superIncidenceOffsets[node + 1] - ctx->superIncidenceOffsets[node];
+		}
+		arcIndices = (uint *)arenaAlloc(&ctx->arena, (numArcsProblem + 1) * sizeof(uint));
+
+		numArcsProblem = 0;
+		for (i = 2; i < problem->numNodesInList; i++)
+		{
+			node = problem->nodeInfo[i].originalIndex;
+			for (j = ctx->superIncidenceOffsets[node]; j < ctx->superIncidenceOffsets[node + 1]; j++)
+			{
+				superArc = &ctx->arcListSuper[ctx->superIncidentArcs[j]];
+				other = superArc->from == node ? superArc->to : superArc->from;
+				if (other != node && (superArc->from == node || contractedIndex(ctx, other, problem) <= 1))
+				{
+					arcIndices[numArcsProblem++] = ctx->superIncidentArcs[j];
+				}
+			}
+		}
+		qsort(arcIndices, numArcsProblem, sizeof(uint), cmpUint);
+	}
+
+	/* allocate space for arcs, at most one per collected arc that is not a terminal arc */
+	problem->arcList = (Arc *)poolAlloc(ctx, numArcsProblem * sizeof(Arc));
+
+	numThreads = arcPassThreads(ctx, numArcsProblem);
+	if (numThreads > 1)
+	{
+		parallelArcPass(ctx, problem, arcIndices, numArcsProblem, numThreads);
+		arenaRelease(&ctx->arena, scratch);
+		return;
+	}
+
+    // Allows avoiding mapping two times
+    // (for better cache usage)
+	/* determine new number of arcs */
+	for (j = 0; j < numArcsProblem; j++)
+	{
+		i = arcIndices == NULL ? j : arcIndices[j];
+		superArc = &ctx->arcListSuper[i];
+		newIndexFrom = contractedIndex(ctx, superArc->from, problem);
+		newIndexTo = contractedIndex(ctx, superArc->to, problem);
+		orientEdge(ctx, superArc, &newIndexFrom, &newIndexTo);
+
+		if (newIndexFrom == newIndexTo || newIndexTo==0 || newIndexFrom==1 || (newIndexFrom == 0 && newIndexTo == 1))
+		{
+		}
+		else if (newIndexFrom == 0)
+		{
+			problem->sourceCapacity[newIndexTo] += arcCapacity(ctx, superArc, lambdaValue);
+		}
+		else if (newIndexTo == 1)
+		{
+			problem->sinkCapacity[newIndexFrom] += arcCapacity(ctx, superArc, lambdaValue);
+		}
+		else
+		{
+			copyArcNew(ctx, problem, newIndexFrom, newIndexTo, &ctx->arcListSuper[i], &problem->arcList[currentArc], lambdaValue);
+			problem->arcList[currentArc].superArc = i;
+			++currentArc;
+		}
+	}
+	arenaRelease(&ctx->arena, scratch);
+
+	/* set number of arcs */
+	problem->numArcs = currentArc;
+}
+
+static void initializeChain(HpfContext *ctx)
+/*************************************************************************
+initializeChain - Start the chain of source sets with the entry above
+the upper bound, at which the nodes that never join the source set join
+*************************************************************************/
+{
+	uint i;
+
+	if (ctx->joinEntries==NULL && (ctx->joinEntries = (uint *)malloc(ctx->numNodesSuper * sizeof(uint))) == NULL)
+	{
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+	ctx->numChainEntries = 0;
+	ctx->topEntry = addChainEntry(ctx, ctx->LAMBDA_HIGH, 1);
+	for (i = 0; i < ctx->numNodesSuper; i++)
+	{
+		ctx->joinEntries[i] = ctx->topEntry;
+	}
+}
+
+static void initializeParametricCut(HpfContext *ctx, CutProblem *lowProblem, CutProblem *highProblem)
+/*************************************************************************
+initializeParametricCut - Set up data structures for parametric cut
+*************************************************************************/
+{
+  initializeChain(ctx);
+
+  /* initialize problem for LAMBDA_LOW */
+  initializeContractedProblem(ctx, lowProblem, NULL, 0, ctx->LAMBDA_LOW, NONE, NONE);
+
+	if (ctx->useParametricCut == 1)
+	{
+		/* initialize problem for LAMBDA_HIGH */
+		initializeContractedProblem(ctx, highProblem, NULL, 0, ctx->LAMBDA_HIGH, NONE, NONE);
+	}
+}
+
+static void linkBreakpoint(HpfContext *ctx, Breakpoint *position, Breakpoint *newBreakpoint)
+/*************************************************************************
+linkBreakpoint - Insert a breakpoint behind position in the linkedlist of
+the root context, or at its end without position
+*************************************************************************/
+{
+	ctx = ctx->root;
+
+	if (position == NULL)
+	{
+		position = ctx->lastBreakpoint;
+	}
+
+	if (position == NULL)
+	{
+		/* initialize list */
+		newBreakpoint->next = NULL;
+		ctx->firstBreakpoint = newBreakpoint;
+		ctx->lastBreakpoint = newBreakpoint;
+	}
+	else
+	{
+		newBreakpoint->next = position->next;
+		position->next = newBreakpoint;
+		if (ctx->lastBreakpoint == position)
+		{
+			/* update head */
+			ctx->lastBreakpoint = newBreakpoint;
+		}
+	}
+}
+
+static Breakpoint * allocateBreakpoint(HpfContext *ctx, double lambdaValue, int placeholder)
+/*************************************************************************
+allocateBreakpoint - Called without the shared lock, running out of
+memory unwinds ctx
+*************************************************************************/
+{
+	Breakpoint *newBreakpoint;
+
+	/* allocate memory for breakpoint*/
+	if ((newBreakpoint= (Breakpoint*)malloc(sizeof(Breakpoint))) == NULL)
+	{
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
+
+	newBreakpoint->lambdaValue = lambdaValue;
+	newBreakpoint->placeholder = placeholder;
+	newBreakpoint->next = NULL;
+	return newBreakpoint;
+}
+
+static Breakpoint * addPlaceholder(HpfContext *ctx, Breakpoint *position)
+/*************************************************************************
+addPlaceholder - Reserve the place of the breakpoints of an interval in
+the linkedlist, so they are output in the order of a depth first search
+whatever order the intervals are solved in. Placeholders are not output.
+*************************************************************************/
+{
+	Breakpoint *placeholder = allocateBreakpoint(ctx, 0, 1);
+
+	lockShared(ctx);
+	linkBreakpoint(ctx, position, placeholder);
+	unlockShared(ctx);
+	return placeholder;
+}
+
+static Breakpoint * addBreakpoint(HpfContext *ctx, Breakpoint *position, double lambdaValue, const CutProblem *problem)
+/*************************************************************************
+addBreakpoint - Adds a breakpoint to the linkedlist, behind position or
+at the end, with the source set of problem as its cut
+*************************************************************************/
+{
+	Breakpoint *newBreakpoint;
+	uint i;
+	time_t rawtime;
+	struct tm info;
+	char timeBuffer[32];
+	HpfContext *root = ctx->root;
+
+	/* assign values */
+	newBreakpoint = allocateBreakpoint(ctx, lambdaValue, 0);
+
+	lockShared(ctx);
+	time( &rawtime );
+	localtime_r( &rawtime, &info );
+  printf("c Found %d breakpoint with lambda = %lf at %s\n", ++root->numBreakpoints, lambdaValue, asctime_r(&info, timeBuffer));  fflush(stdout);
+
+	/* copy cut */
+	for (i = 0; i < ctx->numNodesSuper; i++)
+	{
+		//newBreakpoint->sourceSetIndicator[i] = sourceSetIndicator[i];
+        if ( root->nodeBreakpoints[i] > lambdaValue && inSourceSetOf(ctx, problem, i) )
+        {
+            root->nodeBreakpoints[i] = lambdaValue;
+						printf("c node %d is in the breakpoint\n", i);
+        }
+	}
+
+	/* add breakpoint to linkedlist */
+	linkBreakpoint(ctx, position, newBreakpoint);
+	unlockShared(ctx);
+	return newBreakpoint;
+}/*addBreakpoint*/
+
+static void createMemoryStructures(HpfContext *ctx)
+/*************************************************************************
+createMemoryStructures - creates memory structures
+*************************************************************************/
+{
+	uint from;
+	uint to;
+	uint i;
+	Capacity capacity;
+	Capacity offset;
+
+	/* create out-of-tree adjacency: one slice of numAdjacent arc indices per node.
+	numAdjacent is counted while the arcs of the problem are copied. */
+	ctx->outOfTreeOffsets = (uint *)arenaAlloc(&ctx->arena, (ctx->numNodes + 1) * sizeof(uint));
+
+	ctx->outOfTreeOffsets[0] = 0;
+	for (i=0; i<ctx->numNodes; ++i)
+	{
+		ctx->outOfTreeOffsets[i+1] = ctx->outOfTreeOffsets[i] + ctx->nodeInfo[i].numAdjacent;
+	}
+
+	ctx->outOfTreeArcs = (uint *)arenaAlloc(&ctx->arena, (ctx->outOfTreeOffsets[ctx->numNodes] + 1) * sizeof(uint));
+
+	/* the arcs are internal, the terminal capacities are saturated by simpleInitialization.
+	An edge of weight c is an arc of capacity 2c that carries c units of flow less
+	than the arc: the flow of the edge from tail to head is flow - c, in [-c, c],
+	and the residual capacities capacity - flow and flow of the arc are those of
+	the edge in either direction. It starts at a bound like any arc, here at flow
+	0, with c units from head to tail. */
+	for (i=0; i<ctx->numArcs; i++)
+	{
+		to = ctx->arcList[i].to;
+		from = ctx->arcList[i].from;
+		capacity = ctx->arcList[i].capacity;
+		offset = ctx->undirected ? capacity / 2 : 0;
+
+		if (ctx->warmStartArcs != NULL && ctx->arcList[i].superArc != NONE
+			&& isArcSaturated(ctx->warmStartArcs, ctx->arcList[i].superArc)) {
+			/* warm start: the arc carries its full capacity, so only the reverse
+			residual arc is out of tree and it belongs to the head of the arc */
+			ctx->arcList[i].flow = capacity;
+			ctx->arcList[i].direction = 0;
+			ctx->nodesList[to].excess += capacity - offset;
+			ctx->nodesList[from].excess -= capacity - offset;
+			addOutOfTreeNode(ctx, to, i);
+		} else {
+			ctx->nodesList[to].excess -= offset;
+			ctx->nodesList[from].excess += offset;
+			addOutOfTreeNode(ctx, from, i);
+		}
+	}
+
+	/* allocate memory for root and label count */
+	ctx->strongRoots = (Root *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(Root));
+	ctx->labelCount = (uint *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(uint));
+	ctx->labels = (uint *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(uint));
+
+	/* Initialization of root & labelcount */
+	for (i = 0; i<ctx->numNodes; ++i)
+	{
+		initializeRoot(&ctx->strongRoots[i]);
+		ctx->labelCount[i] = 0;
+		ctx->labels[i] = 0;
+	}
+}
+
+static Capacity evaluateCut(const HpfContext *ctx, CutProblem *problem, const SetWord *sourceSetIndicator)
+/*************************************************************************
+evaluateCut - Capacity of a cut in the graph of a given problem: the
+internal arcs that leave the source set, or the edges that cross it, the
+source arcs of the nodes outside of it and the sink arcs of the nodes in it
+*************************************************************************/
+{
+	uint i;
+	int fromInSet, toInSet;
+	Capacity cutValue = 0;
+	for (i = 0; i < problem->numArcs; ++i)
+	{
+		fromInSet = inSourceSet(sourceSetIndicator, sourceSetIndex(problem, problem->arcList[i].from));
+		toInSet = inSourceSet(sourceSetIndicator, sourceSetIndex(problem, problem->arcList[i].to));
+		if (fromInSet && !toInSet)
+		{
+		  cutValue += edgeCapacity(ctx, &problem->arcList[i]);
+		}
+		else if (ctx->undirected && toInSet && !fromInSet)
+		{
+		  cutValue += edgeCapacity(ctx, &problem->arcList[i]);
+		}
+	}
+	for (i = 2; i < problem->numNodesInList; ++i)
+	{
+		if (inSourceSet(sourceSetIndicator, sourceSetIndex(problem, i)))
+		{
+			cutValue += problem->sinkCapacity[i];
+		}
+		else
+		{
+			cutValue += problem->sourceCapacity[i];
+		}
+	}
+	return cutValue;
+}
+
+static unsigned char * allocateArcBits(HpfContext *ctx)
+/*************************************************************************
+allocateArcBits - Zeroed bit per arc of the super graph, freed with the
+problem that holds it
+*************************************************************************/
+{
+	size_t size = (ctx->numArcsSuper + 7) / 8;
+	unsigned char *arcBits = (unsigned char *)trackedMalloc(ctx, size);
+
+	memset(arcBits, 0, size);
+	return arcBits;
+}
+
+static void saveSaturatedArcs(HpfContext *ctx, unsigned char *arcBits)
+/*************************************************************************
+saveSaturatedArcs - Round the flow of every internal arc of the solved
+problem to its nearest bound and record the saturated arcs by super arc
+index. The contracted problems at lower lambda start from this pseudoflow
+instead of from zero flow: their internal arcs keep their capacity, only
+the terminal arcs change with lambda and are saturated again.
+*************************************************************************/
+{
+	uint i;
+	Arc *arc;
+
+	for (i = 0; i < ctx->numArcs; ++i)
+	{
+		arc = &ctx->arcList[i];
+		if (arc->superArc != NONE && arc->flow > arc->capacity - arc->flow)
+		{
+			arcBits[arc->superArc >> 3] |= (unsigned char) (1 << (arc->superArc & 7));
+		}
+	}
+}
+
+static void assignContractedNodes(HpfContext *ctx, CutProblem *problem, SetWord *sourceSet)
+/*************************************************************************
+assignContractedNodes - Start an empty source set indicator with the
+nodes contracted into the source and sink of problem. Only a graph of all
+nodes has bits for them. The free nodes are assigned afterwards.
+*************************************************************************/
+{
+	if (problem->lowEntry == NONE)
+	{
+		assignSourceSet(sourceSet, ctx->sourceSuper, 1);
+	}
+}
+
+static void retrieveSourceSet(HpfContext *ctx, CutProblem *problem, SetWord *sourceSet)
+/*************************************************************************
+retrieveSourceSet - Source set indicator of the finished run on problem:
+the strong nodes, lifted to label numNodes
+*************************************************************************/
+{
+	uint i;
+
+	assignContractedNodes(ctx, problem, sourceSet);
+	for (i = 2; i<ctx->numNodes; ++i) // start from 2 to ignore artificial source and sink
+	{
+		assignSourceSet(sourceSet, sourceSetIndex(problem, i), ctx->labels[i] >= ctx->numNodes);
+	}
+}
+
+static void residualSourceSets(HpfContext *ctx, CutProblem *problem, SetWord *minimalSourceSet,
+	SetWord *maximalSourceSet)
+/*************************************************************************
+residualSourceSets - Minimal and maximal source set of the minimum cuts at
+the lambda of the finished run on problem. All positive excess sits on
+strong nodes, all deficits on weak nodes, and no residual arc leads from a
+strong to a weak node. Sending nothing is therefore a maximum flow from the
+excess to the deficits: the minimal source set is what the excess reaches
+over residual arcs, the maximal source set is every node that does not
+reach a deficit over residual arcs. The terminal capacities stay
+saturated and have no arcs. At a breakpoint the excess of the nodes that change sides is zero,
+so fractional capacities compare excesses and residual capacities with a
+tolerance relative to the largest capacity.
+*************************************************************************/
+{
+	uint i, j, head, tail, node, other;
+	uint *incidentArcs;
+	uint *incidentEnd;
+	uint *queue;
+	char *reached;
+	Arc *arc;
+	Capacity tolerance = 0;
+
+#ifndef HPF_INTEGER_CAPACITY
+	for (i = 0; i < ctx->numArcs; ++i)
+	{
+		if (edgeCapacity(ctx, &ctx->arcList[i]) > tolerance)
+		{
+			tolerance = edgeCapacity(ctx, &ctx->arcList[i]);
+		}
+	}
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		tolerance = math_max(tolerance, math_max(ctx->sourceCapacity[i], ctx->sinkCapacity[i]));
+	}
+	tolerance = (Capacity) (RESIDUAL_TOL * math_max(1, tolerance));
+#endif
+
+	/* incidence lists of the internal arcs, sliced like the out-of-tree arcs */
+	incidentArcs = (uint *)arenaAlloc(&ctx->arena, (ctx->outOfTreeOffsets[ctx->numNodes] + 1) * sizeof(uint));
+	incidentEnd = (uint *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(uint));
+	queue = (uint *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(uint));
+	reached = (char *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(char));
+
+	for (i = 0; i < ctx->numNodes; ++i)
+	{
+		incidentEnd[i] = ctx->outOfTreeOffsets[i];
+	}
+	for (i = 0; i < ctx->numArcs; ++i)
+	{
+		arc = &ctx->arcList[i];
+		incidentArcs[incidentEnd[arc->from]++] = i;
+		incidentArcs[incidentEnd[arc->to]++] = i;
+	}
+
+	assignContractedNodes(ctx, problem, minimalSourceSet);
+	assignContractedNodes(ctx, problem, maximalSourceSet);
+
+	/* minimal source set: search forward from the nodes with excess */
+	tail = 0;
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		reached[i] = ctx->nodesList[i].excess > tolerance;
+		if (reached[i])
+		{
+			queue[tail++] = i;
+		}
+	}
+	for (head = 0; head < tail; ++head)
+	{
+		node = queue[head];
+		for (j = ctx->outOfTreeOffsets[node]; j < incidentEnd[node]; ++j)
+		{
+			arc = &ctx->arcList[incidentArcs[j]];
+			if (arc->from == node)
+			{
+				other = arc->to;
+				if (arc->capacity - arc->flow <= tolerance) continue;
+			}
+			else
+			{
+				other = arc->from;
+				if (arc->flow <= tolerance) continue;
+			}
+			if (!reached[other])
+			{
+				reached[other] = 1;
+				queue[tail++] = other;
+			}
+		}
+	}
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		assignSourceSet(minimalSourceSet, sourceSetIndex(problem, i), reached[i]);
+	}
+
+	/* maximal source set: search backward from the nodes with a deficit */
+	tail = 0;
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		reached[i] = ctx->nodesList[i].excess < - tolerance;
+		if (reached[i])
+		{
+			queue[tail++] = i;
+		}
+	}
+	for (head = 0; head < tail; ++head)
+	{
+		node = queue[head];
+		for (j = ctx->outOfTreeOffsets[node]; j < incidentEnd[node]; ++j)
+		{
+			arc = &ctx->arcList[incidentArcs[j]];
+			if (arc->to == node)
+			{
+				other = arc->from;
+				if (arc->capacity - arc->flow <= tolerance) continue;
+			}
+			else
+			{
+				other = arc->to;
+				if (arc->flow <= tolerance) continue;
+			}
+			if (!reached[other])
+			{
+				reached[other] = 1;
+				queue[tail++] = other;
+			}
+		}
+	}
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		assignSourceSet(maximalSourceSet, sourceSetIndex(problem, i), !reached[i]);
+	}
+
+}
+
+static int useFreeRuns(HpfContext *ctx)
+/*************************************************************************
+useFreeRuns - Free runs are used for double and float capacities. Integer
+capacities are scaled by the denominator of lambda, which changes the
+capacity of every arc between two lambda values.
+*************************************************************************/
+{
+#ifdef HPF_INTEGER_CAPACITY
+	return 0;
+#else
+	return ctx->freeRuns;
+#endif
+}
+
+static void moveFreeRunExcess(HpfContext *ctx, const uint node, const Capacity delta)
+/*************************************************************************
+moveFreeRunExcess - Add the excess a terminal capacity of node gains in a
+free run, and push it to the root of the tree of node
+*************************************************************************/
+{
+	if (!isExcess(delta))
+	{
+		return;
+	}
+
+	ctx->nodesList[node].excess += delta;
+
+	/* nodes in the source set stay there, their excess is never moved again */
+	if (ctx->labels[node] >= ctx->numNodes)
+	{
+		return;
+	}
+
+	if (ctx->nodesList[node].parent != NONE)
+	{
+		pushExcess(ctx, node);
+	}
+	else if (isExcess(ctx->nodesList[node].excess) > 0 && isExcess(ctx->nodesList[node].excess - delta) <= 0)
+	{
+		addToStrongBucket(ctx->nodesList, node, &ctx->strongRoots[ctx->labels[node]]);
+	}
+}
+
+static int freeRun(HpfContext *ctx, CutProblem *problem, CutProblem *next, SetWord *nextSourceSet)
+/*************************************************************************
+freeRun - Continue the finished pseudoflow run of problem at the higher
+lambda of next, on the same graph. Only the terminal capacities change:
+source capacities grow and sink capacities shrink, so both add excess to
+their node, which is pushed to the root of its tree. Flows, trees and
+labels are kept, the labels of a sequence of free runs only increase
+(Hochbaum 2008, pg. 15). Returns 0 without changing the run if a terminal
+capacity moves the other way or a capacity turns negative that may not be
+rounded, the caller then solves next from scratch.
+*************************************************************************/
+{
+	uint i;
+	uint from;
+	uint to;
+	int *problemIndex;
+	Capacity *sourceCapacity;
+	Capacity *sinkCapacity;
+	Capacity capacity;
+
+	/* terminal capacities at the new lambda, summed like the contraction does */
+	problemIndex = (int *)arenaAlloc(&ctx->arena, ctx->numNodesSuper * sizeof(int));
+	sourceCapacity = (Capacity *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(Capacity));
+	sinkCapacity = (Capacity *)arenaAlloc(&ctx->arena, ctx->numNodes * sizeof(Capacity));
+
+	for (i = 0; i < ctx->numNodesSuper; ++i)
+	{
+		problemIndex[i] = contractedIndex(ctx, i, problem) == 0 ? 0 : 1;
+	}
+	problemIndex[ctx->sourceSuper] = 0;
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		problemIndex[ctx->nodeInfo[i].originalIndex] = i;
+	}
+	for (i = 0; i < ctx->numNodes; ++i)
+	{
+		sourceCapacity[i] = 0;
+		sinkCapacity[i] = 0;
+	}
+
+	for (i = 0; i < ctx->numArcsSuper; ++i)
+	{
+		from = problemIndex[ctx->arcListSuper[i].from];
+		to = problemIndex[ctx->arcListSuper[i].to];
+		orientEdge(ctx, &ctx->arcListSuper[i], &from, &to);
+
+		if (from == to || to == 0 || from == 1 || (from != 0 && to != 1))
+		{
+			continue;
+		}
+
+		capacity = scaledCapacity(ctx, ctx->arcListSuper[i].constant, ctx->arcListSuper[i].multiplier, next->lambdaValue);
+		if (capacity < 0)
+		{
+			if (!ctx->roundNegativeCapacity)
+			{
+				return 0;
+			}
+			capacity = 0;
+		}
+
+		if (from == 0 && to != 1)
+		{
+			sourceCapacity[to] += capacity;
+		}
+		else if (from != 0)
+		{
+			sinkCapacity[from] += capacity;
+		}
+	}
+
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		if (sourceCapacity[i] < ctx->sourceCapacity[i] || sinkCapacity[i] > ctx->sinkCapacity[i])
+		{
+			return 0;
+		}
+	}
+
+	/* move the terminal capacities to the new lambda in one pass over the
+	nodes, they stay saturated. The arrays keep the gains in excess. */
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		capacity = sourceCapacity[i];
+		sourceCapacity[i] = capacity - ctx->sourceCapacity[i];
+		ctx->sourceCapacity[i] = capacity;
+		capacity = sinkCapacity[i];
+		sinkCapacity[i] = ctx->sinkCapacity[i] - capacity;
+		ctx->sinkCapacity[i] = capacity;
+	}
+
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		moveFreeRunExcess(ctx, i, sourceCapacity[i]);
+	}
+	for (i = 2; i < ctx->numNodes; ++i)
+	{
+		moveFreeRunExcess(ctx, i, sinkCapacity[i]);
+	}
+
+	ctx->highestStrongLabel = ctx->numNodes - 1;
+	pseudoflowPhase1(ctx);
+
+	if (next->saturatedArcs != NULL)
+	{
+		saveSaturatedArcs(ctx, next->saturatedArcs);
+	}
+
+	retrieveSourceSet(ctx, problem, nextSourceSet);
+
+	/* the cut of next is evaluated on the graph of problem */
+	next->cutValue = evaluateCut(ctx, problem, nextSourceSet);
+	next->solved = 1;
+
+	printCutProblem(ctx, next);
+	return 1;
+}
+
+static __inline uint regionIndex(const RegionBlock *block, const uint node)
 /*************************************************************************
-readData
+regionIndex - Index of a node of the problem in the block, NONE outside
 *************************************************************************/
 {
-	// printf("OG #nodes %d #arcs %d\n", numNodesSuper, numArcsSuper);
-	if ((nodeListSuper = (Node *)malloc(numNodesSuper * sizeof(Node))) == NULL)
+	if (node < 2)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		return node;
 	}
+	return node >= block->first && node < block->last ? 2 + node - block->first : NONE;
+}
 
-	if ((nodeBreakpoints = (double *)malloc(numNodesSuper * sizeof(double))) == NULL)
+static void * solveRegionBlock(void *arg)
+/*************************************************************************
+solveRegionBlock - Copy the terminal capacities of the nodes of a block
+and the arcs of the problem inside it, drop the arcs that leave it, and
+solve the block. The arcs of the solved block stay in the arena of its
+context. A block that exceeds the arena limit records the error and stops.
+*************************************************************************/
+{
+	RegionBlock *block = (RegionBlock *) arg;
+	HpfContext *blockCtx = block->blockCtx;
+	const CutProblem *problem = block->problem;
+	uint numNodes = 2 + block->last - block->first;
+	uint numArcs = 0;
+	uint i, from, to;
+	const Arc *arc;
+	jmp_buf unwind;
+
+	blockCtx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		block->error = blockCtx->arena.error;
+		return NULL;
 	}
 
+	block->nodeList = (Node *)arenaAlloc(&blockCtx->arena, numNodes * sizeof(Node));
+	block->nodeInfo = (NodeInfo *)arenaAlloc(&blockCtx->arena, numNodes * sizeof(NodeInfo));
+	block->sourceCapacity = (Capacity *)arenaAlloc(&blockCtx->arena, numNodes * sizeof(Capacity));
+	block->sinkCapacity = (Capacity *)arenaAlloc(&blockCtx->arena, numNodes * sizeof(Capacity));
+	for (i = 0; i < numNodes; ++i)
+	{
+		initializeNode(&block->nodeList[i]);
+		initializeNodeInfo(&block->nodeInfo[i]);
+	}
+	block->sourceCapacity[0] = block->sourceCapacity[1] = 0;
+	block->sinkCapacity[0] = block->sinkCapacity[1] = 0;
+	for (i = 2; i < numNodes; ++i)
+	{
+		block->sourceCapacity[i] = problem->sourceCapacity[block->first + i - 2];
+		block->sinkCapacity[i] = problem->sinkCapacity[block->first + i - 2];
+	}
 
-	if ((arcListSuper = (Arc *)malloc(numArcsSuper * sizeof(Arc))) == NULL)
+	for (i = 0; i < problem->numArcs; ++i)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		arc = &problem->arcList[i];
+		from = regionIndex(block, arc->from);
+		to = regionIndex(block, arc->to);
+		if (from != NONE && to != NONE)
+		{
+			++block->nodeInfo[from].numAdjacent;
+			++block->nodeInfo[to].numAdjacent;
+			++numArcs;
+		}
 	}
 
-	/* Initialization */
-	for (int i = 0; i < numNodesSuper; ++i)
+	block->arcList = (Arc *)arenaAlloc(&blockCtx->arena, (numArcs + 1) * sizeof(Arc));
+	numArcs = 0;
+	for (i = 0; i < problem->numArcs; ++i)
 	{
-		initializeNode(&nodeListSuper[i], i);
-		nodeListSuper[i].originalIndex = i;
-        nodeBreakpoints[i] = LAMBDA_HIGH;
+		arc = &problem->arcList[i];
+		from = regionIndex(block, arc->from);
+		to = regionIndex(block, arc->to);
+		if (from != NONE && to != NONE)
+		{
+			initializeArc(&block->arcList[numArcs]);
+			block->arcList[numArcs].from = from;
+			block->arcList[numArcs].to = to;
+			block->arcList[numArcs].capacity = arc->capacity;
+			block->arcList[numArcs].superArc = arc->superArc;
+			++numArcs;
+		}
 	}
 
-    nodeBreakpoints[source] = LAMBDA_LOW;
+	blockCtx->nodesList = block->nodeList;
+	blockCtx->nodeInfo = block->nodeInfo;
+	blockCtx->sourceCapacity = block->sourceCapacity;
+	blockCtx->sinkCapacity = block->sinkCapacity;
+	blockCtx->numNodes = numNodes;
+	blockCtx->numArcs = numArcs;
+	blockCtx->arcList = block->arcList;
+	blockCtx->source = 0;
+	blockCtx->sink = 1;
+	blockCtx->highestStrongLabel = 1;
+
+	createMemoryStructures(blockCtx);
+	simpleInitialization(blockCtx);
+	pseudoflowPhase1(blockCtx);
+	freeMemorySolve(blockCtx);
+	return NULL;
+}
+
+static unsigned char * regionWarmStart(HpfContext *ctx, CutProblem *problem)
+/*************************************************************************
+regionWarmStart - Split the free nodes of a problem into one block of
+consecutive nodes per thread of the context, solve the blocks in parallel
+without the arcs between them, and return their flows rounded to the
+saturated arcs, the warm start of the problem. Consecutive nodes of a grid
+numbered in raster order are slabs of the grid, so few arcs leave a block
+and the solve of the problem mostly reconciles the flows on them. The
+calling thread solves the first block, and the blocks of the threads that
+could not be created. The error of a block unwinds ctx once all blocks are
+done.
+*************************************************************************/
+{
+	uint numThreads = contextThreads(ctx);
+	uint numFreeNodes = problem->numNodesInList - 2;
+	unsigned char *arcBits = allocateArcBits(ctx);
+	RegionBlock *blocks = NULL;
+	pthread_t *threadIds = NULL;
+	HpfContext *blockCtx;
+	uint i, numStarted;
+	int error = HPF_OK;
+
+	if ((blocks = (RegionBlock *)calloc(numThreads, sizeof(RegionBlock))) == NULL ||
+		(threadIds = (pthread_t *)malloc(numThreads * sizeof(pthread_t))) == NULL)
+	{
+		error = HPF_ERROR_OUT_OF_MEMORY;
+		numThreads = 0;
+	}
 
-	for (int i = 0; i < numArcsSuper; ++i)
+	for (i = 0; i < numThreads; ++i)
 	{
-		initializeArc(&arcListSuper[i]);
+		if ((blocks[i].blockCtx = hpf_context_create()) == NULL)
+		{
+			error = HPF_ERROR_OUT_OF_MEMORY;
+			continue;
+		}
+		blocks[i].problem = problem;
+		blocks[i].blockCtx->arena.shared = &ctx->root->arena;
+		blocks[i].blockCtx->arena.sharedLock = &ctx->root->lock;
+		blocks[i].blockCtx->undirected = ctx->undirected;
+		blocks[i].first = 2 + (uint) ((ullint) numFreeNodes * i / numThreads);
+		blocks[i].last = 2 + (uint) ((ullint) numFreeNodes * (i + 1) / numThreads);
+		blocks[i].error = HPF_OK;
 	}
 
-	if (LAMBDA_LOW == LAMBDA_HIGH)
+	numStarted = 1;
+	if (error == HPF_OK)
 	{
-		useParametricCut = 0;
+		for (; numStarted < numThreads; ++numStarted)
+		{
+			if (pthread_create(&threadIds[numStarted], NULL, solveRegionBlock, &blocks[numStarted]) != 0)
+			{
+				break;
+			}
+		}
+		solveRegionBlock(&blocks[0]);
+		for (i = numStarted; i < numThreads; ++i)
+		{
+			solveRegionBlock(&blocks[i]);
+		}
 	}
 
-	for (int i=0; i < numArcsSuper; ++i)
+	for (i = 0; i < numThreads; ++i)
 	{
-		int from = (int) arcMatrix[i * 4 + 0];
-		int to = (int) arcMatrix[i * 4 + 1];
-		double constantCapacity = arcMatrix[ i * 4 + 2 ];
-		double multiplierCapacity = arcMatrix[ i * 4 + 3 ];
+		if (i > 0 && i < numStarted)
+		{
+			pthread_join(threadIds[i], NULL);
+		}
+		if ((blockCtx = blocks[i].blockCtx) == NULL)
+		{
+			continue;
+		}
+		if (blocks[i].error != HPF_OK)
+		{
+			error = blocks[i].error;
+		}
+		else if (error == HPF_OK)
+		{
+			saveSaturatedArcs(blockCtx, arcBits);
+		}
 
-		arcListSuper[i].constant = constantCapacity;
-		arcListSuper[i].multiplier = multiplierCapacity;
-		arcListSuper[i].from = &nodeListSuper[from];
-		arcListSuper[i].to = &nodeListSuper[to];
+		ctx->numArcScans += blockCtx->numArcScans;
+		ctx->numMergers += blockCtx->numMergers;
+		ctx->numPushes += blockCtx->numPushes;
+		ctx->numRelabels += blockCtx->numRelabels;
+		ctx->numGaps += blockCtx->numGaps;
+		hpf_context_destroy(blockCtx);
+	}
 
-		++nodeListSuper[from].numAdjacent;
-		++nodeListSuper[to].numAdjacent;
+	free(blocks);
+	free(threadIds);
+	if (error != HPF_OK)
+	{
+		trackedFree(ctx, arcBits, (ctx->numArcsSuper + 7) / 8);
+		arenaRaise(&ctx->arena, error);
 	}
+	return arcBits;
 }
 
-static void pseudoflowPhase1 (void)
-{
+static int useRegions(HpfContext *ctx, CutProblem *problem)
 /*************************************************************************
-pseudoflowPhase1
+useRegions - Whether a problem starts from the flows of its blocks: it
+has no warm start of its own, at least regionNodes nodes and the context
+has several threads for it
 *************************************************************************/
-	Node *strongRoot;
-	uint nbStrongRoot = 0;
-	while ((strongRoot = getHighestStrongRoot ()))
-	{
-		processRoot (strongRoot);
-		nbStrongRoot += 1;
-		// printf("Number of strong roots processed is %d", nbStrongRoot);
-	}
+{
+	return ctx->regionNodes > 0 && problem->warmStartArcs == NULL
+		&& problem->numNodesInList >= ctx->regionNodes && contextThreads(ctx) > 1;
 }
 
-static void prepareOutput (int * numBreakpoints, double ** cuts, double ** breakpoints, int stats[5] )
-{
+static void solveProblem(HpfContext *ctx, CutProblem *problem, CutProblem *maximal, CutProblem *next)
 /*************************************************************************
-printOutput
+solveProblem - solves a single instance of cut problem. With maximal, the
+source set of problem is the minimal and the one of maximal the maximal
+source set at the same lambda (see residualSourceSets). With next, the run
+continues with a free run at the lambda of next (see freeRun), and next is
+left unsolved if the free run is not possible.
 *************************************************************************/
-	Breakpoint *currentBreakpoint;
-	int i;
-	int j;
+{
+	SetWord *tempSourceSet;
+	SetWord *maximalSourceSet = NULL;
+	SetWord *nextSourceSet = NULL;
+	unsigned char *regionArcs = NULL;
+	ArenaMark scratch;
+
+	ctx->nodesList = problem->nodeList;
+	ctx->nodeInfo = problem->nodeInfo;
+	ctx->sourceCapacity = problem->sourceCapacity;
+	ctx->sinkCapacity = problem->sinkCapacity;
+	ctx->numNodes = problem->numNodesInList;
+	ctx->numArcs = problem->numArcs;
+	problem->cutValue = 0.0;
 
-	stats[0] = numArcScans;
-	stats[1] = numMergers;
-	stats[2] = numPushes;
-	stats[3] = numRelabels;
-	stats[4] = numGaps;
+    // reset some globals
+    ctx->highestStrongLabel = 1;
+	ctx->lowestPositiveExcessNode = 0;
 
-	/* count num breakpoints */
-	*numBreakpoints = 0;
-	currentBreakpoint = firstBreakpoint;
-	while (currentBreakpoint != NULL)
+
+	// handle empty problems
+	if (ctx->numNodes == 2)
 	{
-		++*numBreakpoints;
-		currentBreakpoint = currentBreakpoint->next;
+		/* assign nodes to source / sink set */
+		assignContractedNodes(ctx, problem, allocateSourceSet(ctx, problem, problem));
+
+		/* no arc is left, the arcs from the source to the sink are common to all cuts */
+        problem->solved =1;
+
+		// without free nodes the minimal and maximal source set coincide
+		if (maximal != NULL)
+		{
+			memcpy(allocateSourceSet(ctx, problem, maximal), problem->optimalSourceSetIndicator,
+				problem->setWords * sizeof(SetWord));
+			maximal->cutValue = problem->cutValue;
+			maximal->solved = 1;
+		}
+		return;
 	}
 
-	double* breakpointsPointer;
-	/* print lambda values */
-	if ((breakpointsPointer = (double *)malloc(*numBreakpoints * sizeof(double))) == NULL)
+
+	/* allocate memory for the source sets. They outlive the solve, so they are
+	not taken from the arena. */
+	tempSourceSet = allocateSourceSet(ctx, problem, problem);
+	if (maximal != NULL)
+	{
+		maximalSourceSet = allocateSourceSet(ctx, problem, maximal);
+	}
+	if (next != NULL)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		nextSourceSet = allocateSourceSet(ctx, problem, next);
 	}
 
-	currentBreakpoint = firstBreakpoint;
-	for (i = 0; i < *numBreakpoints; i++)
+	scratch = arenaMark(&ctx->arena);
+
+	ctx->source = 0;
+	ctx->sink = 1;
+	ctx->arcList = problem->arcList;
+
+	// solve
+	ctx->warmStartArcs = problem->warmStartArcs;
+	if (useRegions(ctx, problem))
 	{
-		breakpointsPointer[i] = (double) currentBreakpoint->lambdaValue;
-		currentBreakpoint = currentBreakpoint->next;
+		regionArcs = regionWarmStart(ctx, problem);
+		ctx->warmStartArcs = regionArcs;
 	}
+	createMemoryStructures(ctx);
+	simpleInitialization(ctx);
+	pseudoflowPhase1(ctx);
+	ctx->warmStartArcs = NULL;
+	trackedFree(ctx, regionArcs, (ctx->numArcsSuper + 7) / 8);
 
-	*breakpoints = breakpointsPointer;
+	if (problem->saturatedArcs != NULL)
+	{
+		saveSaturatedArcs(ctx, problem->saturatedArcs);
+	}
 
-	/* print values nodes*/
-	double* cutsPointer;
-	if ((cutsPointer = (double *)malloc( numNodesSuper * sizeof(double))) == NULL)
+	if (maximal != NULL)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		residualSourceSets(ctx, problem, tempSourceSet, maximalSourceSet);
+	}
+	else
+	{
+		retrieveSourceSet(ctx, problem, tempSourceSet);
 	}
 
-    for (j = 0; j < numNodesSuper; j++)
-    {
-        cutsPointer[j] = nodeBreakpoints[j];
-    }
+	// assign cut
+	problem->cutValue = evaluateCut(ctx, problem, tempSourceSet);
 
-	*cuts = cutsPointer;
-}
+    problem->solved =1;
+
+	printCutProblem(ctx, problem);
+	// printf("lambda:%.12lf\n" ,problem->lambdaValue);
+
+	if (maximal != NULL)
+	{
+		maximal->cutValue = evaluateCut(ctx, problem, maximalSourceSet);
+		maximal->solved = 1;
+
+		printCutProblem(ctx, maximal);
+	}
 
+	if (nextSourceSet != NULL && !freeRun(ctx, problem, next, nextSourceSet))
+	{
+		freeSourceSet(ctx, next);
+	}
 
+	freeMemorySolve(ctx);
+	arenaRelease(&ctx->arena, scratch);
+}
 
-static void copyArcNew(CutProblem *problem, int *nodeMap, Arc *old, Arc *new,
-	double lambda)
+static void evaluateCutFunction(HpfContext *ctx, CutProblem *problem)
 /*************************************************************************
-copyArcNew - copy basic info arc and point to new nodes
+evaluateCutFunction - Size and cut function of the source set of a solved
+problem, in one pass over the super graph. The constant sums the constants
+of the arcs leaving the source set and of the edges crossing it, except the
+source arcs, and the multiplier those of the sink arcs among them. The
+capacity of the source arc of a node in the source set is subtracted; the
+source arcs dropped are the same for every source set, so differences of
+cut functions are exact. Capacities are taken linear, roundedIntersect
+corrects the rounded ones. Used for the bound problems, the recursion
+derives the cut functions of its subproblems (see deriveCutFunction).
 *************************************************************************/
 {
-	uint newIndexFrom;
-	uint newIndexTo;
-
-	initializeArc(new);
-	new->capacity = old->multiplier * lambda + old->constant;
-
-    if (new->capacity < 0)
-    {
-        if (roundNegativeCapacity)
-        {
-            new->capacity = 0;
-        }
-        else
-        {
-            printf("Negative capacity for lambda equal to %lf. Set roundNegativeCapacity to 1 if the value should be rounded to 0.\n",problem->lambdaValue);
-            exit(0);
-        }
-    }
+	uint i;
+	const Arc *arc;
+	const SetWord *sourceSet = problem->optimalSourceSetIndicator;
 
+	problem->sourceSetSize = sourceSetSize(ctx, sourceSet);
+	problem->cutConstant = 0;
+	problem->cutMultiplier = 0;
 
-	/* set start and end node */
-	newIndexFrom = nodeMap[old->from->number];
-	newIndexTo = nodeMap[old->to->number];
-	new->from = &problem->nodeList[newIndexFrom];
-	new->to = &problem->nodeList[newIndexTo];
+	for (i = 0; i < ctx->numArcsSuper; ++i)
+	{
+		arc = &ctx->arcListSuper[i];
+		if (arc->from == ctx->sourceSuper)
+		{
+			if (arc->to != ctx->sourceSuper && inSourceSet(sourceSet, arc->to))
+			{
+				problem->cutConstant -= arc->constant;
+				problem->cutMultiplier -= arc->multiplier;
+			}
+			continue;
+		}
 
-	/* update degree nodes*/
-	++ new->from->numAdjacent;
-	++ new->to->numAdjacent;
+		if (inSourceSet(sourceSet, arc->from) && !inSourceSet(sourceSet, arc->to))
+		{
+			problem->cutConstant += arc->constant;
+			if (arc->to == ctx->sinkSuper)
+			{
+				problem->cutMultiplier += arc->multiplier;
+			}
+		}
+		else if (isEdge(ctx, arc) && inSourceSet(sourceSet, arc->to) && !inSourceSet(sourceSet, arc->from))
+		{
+			problem->cutConstant += arc->constant;
+		}
+	}
 }
 
-static void copyArcAdd(Arc *old, Arc *new, double lambda)
+static void deriveCutFunction(HpfContext *ctx, const CutProblem *graphProblem, const CutProblem *base,
+	CutProblem *problem)
 /*************************************************************************
-copyArcAdd - update arc by adding another
+deriveCutFunction - Size and cut function of the source set of problem,
+found by a solve on the graph of graphProblem, from those of base, the
+problem whose source set was contracted into the source of graphProblem.
+Only the nodes that moved to the source side and their arcs are scanned,
+so the cost is bounded by the size of graphProblem. base is in the chain,
+graphProblem is the last contraction of ctx.
 *************************************************************************/
-
 {
-    double additional_capacity = old->multiplier * lambda + old->constant;
+	uint i, j, node;
+	const Arc *arc;
+	const SetWord *sourceSet = problem->optimalSourceSetIndicator;
 
-    if (additional_capacity < 0)
-    {
-        if (roundNegativeCapacity)
-        {
-            additional_capacity = 0;
-        }
-        else
-        {
-            printf("Negative capacity for lambda equal to %lf. Set roundNegativeCapacity to 1 if the value should be rounded to 0.\n", lambda);
-            exit(0);
-        }
-    }
-    new->capacity +=  additional_capacity;
+	problem->sourceSetSize = base->sourceSetSize;
+	problem->cutConstant = base->cutConstant;
+	problem->cutMultiplier = base->cutMultiplier;
+
+	for (i = 2; i < graphProblem->numNodesInList; ++i)
+	{
+		node = graphProblem->nodeInfo[i].originalIndex;
+		if (!inSourceSet(sourceSet, i - 2))
+		{
+			continue;
+		}
+
+		++problem->sourceSetSize;
+		for (j = ctx->superIncidenceOffsets[node]; j < ctx->superIncidenceOffsets[node + 1]; ++j)
+		{
+			arc = &ctx->arcListSuper[ctx->superIncidentArcs[j]];
+			if (arc->from == node)
+			{
+				// leaves the source set now
+				if (!inSourceSetOf(ctx, problem, arc->to))
+				{
+					problem->cutConstant += arc->constant;
+					if (arc->to == ctx->sinkSuper)
+					{
+						problem->cutMultiplier += arc->multiplier;
+					}
+				}
+				else if (isEdge(ctx, arc) && inSourceSetOf(ctx, base, arc->to))
+				{
+					// an edge that crossed the source set of base, is internal now
+					problem->cutConstant -= arc->constant;
+				}
+			}
+			if (arc->to == node)
+			{
+				if (arc->from == ctx->sourceSuper)
+				{
+					problem->cutConstant -= arc->constant;
+					problem->cutMultiplier -= arc->multiplier;
+				}
+				else if (inSourceSetOf(ctx, base, arc->from))
+				{
+					// left the source set of base, is internal now
+					problem->cutConstant -= arc->constant;
+				}
+				else if (isEdge(ctx, arc) && !inSourceSetOf(ctx, problem, arc->from))
+				{
+					// an edge that crosses the source set now
+					problem->cutConstant += arc->constant;
+				}
+			}
+		}
+	}
 }
 
-static void destroyProblem(CutProblem *problem, int destroySourceSetIndicator)
+static Lambda computeIntersect(HpfContext *ctx, const CutProblem *lowProblem, const CutProblem *highProblem)
 /*************************************************************************
-destroyProblem - Destruct function for CutProblem struct
+computeIntersect - lambda at which the cut functions of the source sets of
+two problems intersect
 *************************************************************************/
 {
-	problem->sourceSet = NULL;
-	problem->sinkSet = NULL;
-	problem->nodeList = NULL;
-	problem->arcList = NULL;
-    if (destroySourceSetIndicator)
+    CutCoefficient constant = lowProblem->cutConstant - highProblem->cutConstant;
+    CutCoefficient multiplier = lowProblem->cutMultiplier - highProblem->cutMultiplier;
+
+#ifdef HPF_INTEGER_CAPACITY
+    if (multiplier == 0)
+    {
+        // parallel cut functions: no interior intersection
+        return ctx->LAMBDA_LOW;
+    }
+    return makeLambda(constant, - multiplier);
+#else
+    if (multiplier == 0)
     {
-        free(problem->optimalSourceSetIndicator);
-        problem->optimalSourceSetIndicator = NULL;
+        // parallel cut functions: no interior intersection
+        return ctx->LAMBDA_LOW;
     }
+    return constant / (- multiplier);
+#endif
 }
 
-static void initializeContractedProblem(CutProblem *problem, Node *nodeListProblem,
-	uint numNodesProblem, Arc *arcListProblem, uint numArcsProblem,
-	const double lambdaValue, char *solutionLow, char *solutionHigh,
-    int cacheId)
+static int cmpLambda(const void *a, const void *b)
+{
+	return lambdaCompare(*(const Lambda *)a, *(const Lambda *)b);
+}
+
+static Lambda roundedIntersect(HpfContext *ctx, const CutProblem *lowProblem, const CutProblem *highProblem,
+	const uint *freeNodes, uint numFreeNodes, int *atKink)
 /*************************************************************************
-initializeContractedProblem - Setup problems for parametric cut
+roundedIntersect - computeIntersect for rounded negative capacities. A
+terminal arc of a free node whose capacity changes sign inside the
+interval bends the cut functions, and a node can be indifferent over a
+whole range, so the intersection proves nothing there. Such an interval
+is split at its median kink instead, and atKink is set. Without kinks
+inside, every capacity is linear on the interval and the intersection is
+taken on the pieces that hold inside it.
 *************************************************************************/
 {
-	uint i, newIndexTo, newIndexFrom;
-	uint currentNode = 2;
-    uint currentSourceSet = 0;
-    uint currentSinkSet = 0;
-    uint currentArc = 0;
+	CutCoefficient constant = lowProblem->cutConstant - highProblem->cutConstant;
+	CutCoefficient multiplier = lowProblem->cutMultiplier - highProblem->cutMultiplier;
+	Lambda low = lowProblem->lambdaValue;
+	Lambda high = highProblem->lambdaValue;
+	Lambda kink = low;
+	Capacity value;
+	const Arc *arc;
+	Lambda *kinks;
+	uint i, j, node, numKinks = 0, maxKinks = 0;
+
+	for (i = 0; i < numFreeNodes; ++i)
+	{
+		maxKinks += ctx->superIncidenceOffsets[freeNodes[i] + 1] - ctx->superIncidenceOffsets[freeNodes[i]];
+	}
+	kinks = (Lambda *)trackedMalloc(ctx, (maxKinks + 1) * sizeof(Lambda));
 
-	/* set cut parameters */
-	problem->cutValue = 0;
+	for (i = 0; i < numFreeNodes; ++i)
+	{
+		node = freeNodes[i];
+		for (j = ctx->superIncidenceOffsets[node]; j < ctx->superIncidenceOffsets[node + 1]; ++j)
+		{
+			arc = &ctx->arcListSuper[ctx->superIncidentArcs[j]];
+			if (arc->from != ctx->sourceSuper && arc->to != ctx->sinkSuper)
+			{
+				continue;
+			}
 
-	/* set solved indicator */
-	problem->solved = 0;
+			/* the rounded capacity of a negative piece is zero, not constant + multiplier * lambda.
+			Without kinks inside, the sign is the same at both ends of the interval or zero at one. */
+			value = scaledCapacity(ctx, arc->constant, arc->multiplier, low) + scaledCapacity(ctx, arc->constant, arc->multiplier, high);
+			if (value < 0)
+			{
+				if (arc->from == ctx->sourceSuper)
+				{
+					constant -= arc->constant;
+					multiplier -= arc->multiplier;
+				}
+				else
+				{
+					constant += arc->constant;
+					multiplier += arc->multiplier;
+				}
+			}
+			if (arc->multiplier != 0)
+			{
+				kink = arc->multiplier > 0 ? lambdaRatio(- arc->constant, arc->multiplier)
+					: lambdaRatio(arc->constant, - arc->multiplier);
+				if (lambdaCompare(kink, low) > 0 && lambdaCompare(kink, high) < 0)
+				{
+					kinks[numKinks++] = kink;
+				}
+			}
+		}
+	}
 
-	/* initialize optimal cut */
-	problem->optimalSourceSetIndicator = NULL;
+	*atKink = numKinks > 0;
+	if (numKinks > 0)
+	{
+		qsort(kinks, numKinks, sizeof(Lambda), cmpLambda);
+		kink = kinks[numKinks / 2];
+	}
+	trackedFree(ctx, kinks, (maxKinks + 1) * sizeof(Lambda));
 
-	/* initialize new lambda value */
-	problem->lambdaValue = lambdaValue;
-	/* set size of node sets */
-	problem->numSourceSet = 0;
-	problem->numSinkSet = 0;
-	problem->numNodesInList = 2;
+	if (*atKink)
+	{
+		return kink;
+	}
+	if (multiplier == 0)
+	{
+		// the cut functions agree on the whole interval
+		return low;
+	}
+#ifdef HPF_INTEGER_CAPACITY
+	return makeLambda(constant, - multiplier);
+#else
+	return constant / (- multiplier);
+#endif
+}
 
-	/* allocateSpace for nodeMap */
-	if (nodeMap==NULL && (nodeMap = (int *)malloc(numNodesProblem* sizeof(int))) == NULL)
+static int joinsAtIntersect(HpfContext *ctx, const CutProblem *lowProblem, const CutProblem *highProblem,
+	const CutProblem *minimal, const CutProblem *maximal)
+/*************************************************************************
+joinsAtIntersect - Whether the intersection solved by minimal and maximal
+is a breakpoint. The nodes of the maximal source set outside the minimal
+one are indifferent at the intersection. They join the source set there
+only if their terminal arcs change the slope of the cut function; a node
+without parametric arcs, or one that only follows such a node, is
+indifferent at every lambda and stays free. Rounded capacities take the
+slope of the piece that holds on the interval (see roundedIntersect).
+*************************************************************************/
+{
+	uint i, j, node;
+	const Arc *arc;
+	Lambda low = lowProblem->lambdaValue;
+	Lambda high = highProblem->lambdaValue;
+	double slope = 0;
+	double magnitude = 0;
+
+	if (maximal->sourceSetSize == minimal->sourceSetSize)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		return 0;
 	}
 
-    for (i = 0; i < numNodesProblem; i++)
+	for (i = 2; i < minimal->numNodesInList; ++i)
 	{
-        if (i == sourceSuper || solutionLow[i] == 1)
-        {   // Source set nodes
-			nodeMap[i] = 0;
-            problem->numSourceSet++;
-        }
-        else if (i == sinkSuper || solutionHigh[i] == 0)
-        {
-            // sink set nodes
-			nodeMap[i] = 1;
-            problem->numSinkSet++;
-        }
-        else
-        {
-            nodeMap[i] = currentNode;
-			++currentNode;
-            problem->numNodesInList++;
-        }
+		if (inSourceSet(minimal->optimalSourceSetIndicator, i - 2)
+			|| !inSourceSet(maximal->optimalSourceSetIndicator, i - 2))
+		{
+			continue;
+		}
+
+		node = minimal->nodeInfo[i].originalIndex;
+		for (j = ctx->superIncidenceOffsets[node]; j < ctx->superIncidenceOffsets[node + 1]; ++j)
+		{
+			arc = &ctx->arcListSuper[ctx->superIncidentArcs[j]];
+			if ((arc->from != ctx->sourceSuper && arc->to != ctx->sinkSuper) || arc->multiplier == 0)
+			{
+				continue;
+			}
+			if (ctx->roundNegativeCapacity
+				&& scaledCapacity(ctx, arc->constant, arc->multiplier, low) + scaledCapacity(ctx, arc->constant, arc->multiplier, high) < 0)
+			{
+				// rounded to zero on the interval
+				continue;
+			}
+			slope += arc->from == ctx->sourceSuper ? - (double) arc->multiplier : (double) arc->multiplier;
+			magnitude += dabs((double) arc->multiplier);
+		}
 	}
 
-	/* allocate space for the node sets*/
-    int initStructures = nodeListCache[cacheId]==NULL;
-	if (nodeListCache[cacheId]==NULL && (nodeListCache[cacheId] = (Node *)malloc(numNodesProblem* sizeof(Node))) == NULL)
-	{
-		printf("Out of memory\n");
-		exit(0);
-	}
-    problem->nodeList = nodeListCache[cacheId];
-	if (sourceSetCache[cacheId]==NULL && (sourceSetCache[cacheId] = (Node *)malloc(numNodesProblem* sizeof(Node))) == NULL)
-	{
-		printf("Out of memory\n");
-		exit(0);
-	}
-    problem->sourceSet = sourceSetCache[cacheId];
-	if (sinkSetCache[cacheId]==NULL && (sinkSetCache[cacheId] = (Node *)malloc(numNodesProblem * sizeof(Node))) == NULL)
-	{
-		printf("Out of memory\n");
-		exit(0);
-	}
-    problem->sinkSet = sinkSetCache[cacheId];
+#ifdef HPF_INTEGER_CAPACITY
+	return slope != 0;
+#else
+	return dabs(slope) > RESIDUAL_TOL * magnitude;
+#endif
+}
 
-    // initialize nodes
-    for (i = 0; i < problem->numNodesInList; i++)
-    {
-        initializeNode(&problem->nodeList[i], i);
-    }
-    for (i = 0; i < problem->numSourceSet; i++)
-    {
-        initializeNode(&problem->sourceSet[i], i);
-    }
-    for (i = 0; i < problem->numSinkSet; i++)
-    {
-        initializeNode(&problem->sinkSet[i], i);
-    }
-     /* source is always first node */
-    problem->nodeList[0].originalIndex = -1; /* indicate artificial source node */
-    problem->nodeList[1].originalIndex = -2; /* indicate artificial sink node */
+static void addIntersectEntries(HpfContext *ctx, const CutProblem *low, const CutProblem *high,
+	CutProblem *minimal, CutProblem *maximal)
+/*************************************************************************
+addIntersectEntries - Chain entries of the minimal and maximal source set
+at the intersection of an interval, between the entries of its endpoints.
+At the lambda of an endpoint they are ordered between its order and the
+order next to it.
+*************************************************************************/
+{
+	const ChainEntry *lowEntry = chainEntry(ctx, low->entry);
+	const ChainEntry *highEntry = chainEntry(ctx, high->entry);
+	double first = lambdaCompare(minimal->lambdaValue, lowEntry->lambdaValue) == 0 ? lowEntry->order : 0;
+	double last = lambdaCompare(minimal->lambdaValue, highEntry->lambdaValue) == 0 ? highEntry->order : 1;
+
+	minimal->entry = addChainEntry(ctx, minimal->lambdaValue, first + (last - first) / 3);
+	maximal->entry = addChainEntry(ctx, maximal->lambdaValue, first + 2 * (last - first) / 3);
+}
+
+static void pushInterval(HpfContext *ctx, CutProblem *low, CutProblem *high, uint *freeNodes,
+	uint numFreeNodes, Breakpoint *position)
+/*************************************************************************
+pushInterval - Add an open interval to the queue of the root context. The
+interval holds a reference to both endpoints unless the cap on intervals
+with warm start arcs is reached, then it is deferred and keeps only their
+lambda values and chain entries.
+*************************************************************************/
+{
+	HpfContext *root = ctx->root;
+	Interval *interval;
+	Interval *intervals;
+	uint i;
+	int deferred = 0;
 
-	/* create new node sets*/
-	for (i = 0; i < numNodesProblem; i++)
+	lockShared(ctx);
+	if (root->numIntervals == root->intervalsSize)
 	{
-        if(nodeMap[i] > 1){
-			problem->nodeList[nodeMap[i]].originalIndex = nodeListProblem[i].originalIndex;
-        }else if (nodeMap[i] == 0)
+		/* grow the ring buffer, unwrapping it from the head */
+		uint size = root->intervalsSize > 0 ? 2 * root->intervalsSize : 64;
+		if ((intervals = (Interval *)malloc(size * sizeof(Interval))) == NULL)
 		{
-			problem->sourceSet[currentSourceSet].originalIndex = nodeListProblem[i].originalIndex;
-			currentSourceSet++;
+			unlockShared(ctx);
+			arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
 		}
-		else
+		for (i = 0; i < root->numIntervals; ++i)
 		{
-			problem->sinkSet[currentSinkSet].originalIndex = nodeListProblem[i].originalIndex;
-			currentSinkSet++;
+			intervals[i] = root->intervals[(root->intervalsHead + i) % root->intervalsSize];
 		}
+		free(root->intervals);
+		root->intervals = intervals;
+		root->intervalsSize = size;
+		root->intervalsHead = 0;
 	}
 
+	interval = &root->intervals[(root->intervalsHead + root->numIntervals) % root->intervalsSize];
+	++root->numIntervals;
+	if (root->numIntervals > root->maxQueueDepth)
+	{
+		root->maxQueueDepth = root->numIntervals;
+	}
 
-    /* allocate space for source and sink arc indices */
-	if (sourceAdjacentArcIndices==NULL && (sourceAdjacentArcIndices = (int *)malloc( numNodesProblem*  sizeof(int))) == NULL)
+	interval->lowLambda = low->lambdaValue;
+	interval->highLambda = high->lambdaValue;
+	interval->lowMaximal = low->maximalSet;
+	interval->highMaximal = high->maximalSet;
+	interval->lowEntry = low->entry;
+	interval->highEntry = high->entry;
+	interval->position = position;
 
+	if (root->openIntervalCap > 0 && root->numMaterializedIntervals >= root->openIntervalCap)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		deferred = 1;
+		interval->low = NULL;
+		interval->high = NULL;
+		interval->freeNodes = NULL;
+		interval->numFreeNodes = 0;
 	}
-	if (sinkAdjacentArcIndices==NULL && (sinkAdjacentArcIndices = (int *)malloc(numNodesProblem  *sizeof(int))) == NULL )
+	else
 	{
-		printf("Out of memory\n");
-		exit(0);
+		++low->references;
+		++high->references;
+		++root->numMaterializedIntervals;
+		interval->low = low;
+		interval->high = high;
+		interval->freeNodes = freeNodes;
+		interval->numFreeNodes = numFreeNodes;
 	}
 
-	/* initialize indices */
-	for (i = 0; i < problem->numNodesInList; i++)
+	if (root->numWorkers > 0)
 	{
-		sourceAdjacentArcIndices[i] = -1;
-		sinkAdjacentArcIndices[i] = -1;
+		pthread_cond_signal(&root->workChanged);
 	}
+	unlockShared(ctx);
 
+	if (deferred)
+	{
+		trackedFree(ctx, freeNodes, (numFreeNodes + 1) * sizeof(uint));
+	}
+}
 
-	/* allocate space for arcs */
-    // Note :  allocating for worst case!
-	if (arcListCache[cacheId]==NULL &&(arcListCache[cacheId] = (Arc *)malloc(numArcsProblem * sizeof(Arc))) == NULL)
+static void popInterval(HpfContext *root, Interval *interval)
+/*************************************************************************
+popInterval - Take the last interval (depth first) or the first interval
+(breadth first) from the queue. The caller holds the shared lock.
+*************************************************************************/
+{
+	if (root->breadthFirst)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		*interval = root->intervals[root->intervalsHead];
+		root->intervalsHead = (root->intervalsHead + 1) % root->intervalsSize;
 	}
-    problem->arcList = arcListCache[cacheId];
+	else
+	{
+		*interval = root->intervals[(root->intervalsHead + root->numIntervals - 1) % root->intervalsSize];
+	}
+	--root->numIntervals;
 
-    // Allows avoiding mapping two times
-    // (for better cache usage)
-	/* determine new number of arcs */
-	for (i = 0; i < numArcsProblem; i++)
+	if (interval->low != NULL)
 	{
-		newIndexFrom = nodeMap[arcListProblem[i].from->number];
-		newIndexTo = nodeMap[arcListProblem[i].to->number];
+		--root->numMaterializedIntervals;
+	}
+}
 
-		if (newIndexFrom == newIndexTo || newIndexTo==0 || newIndexFrom==1 || (newIndexFrom == 0 && newIndexTo == 1))
-		{
-		}
-		else if (newIndexFrom == 0)
-		{
-			if (sourceAdjacentArcIndices[newIndexTo] == -1)
-			{
-				sourceAdjacentArcIndices[newIndexTo] = currentArc;
-				copyArcNew(problem, nodeMap, &arcListProblem[i], &problem->arcList[currentArc], lambdaValue);
-				++currentArc;
-			}
-			else
-			{
-				copyArcAdd(&arcListProblem[i], &problem->arcList[sourceAdjacentArcIndices[newIndexTo]], lambdaValue);
-			}
-		}
-		else if (newIndexTo == 1)
+static void joinChain(HpfContext *ctx, CutProblem **problems, uint numProblems)
+/*************************************************************************
+joinChain - Enter problems solved on the full graph into the chain, in
+increasing order of their entries. Each node joins the source set at the
+first problem that holds it, the other nodes stay at the top entry.
+*************************************************************************/
+{
+	size_t numWords = sourceSetWords(ctx->numNodesSuper);
+	size_t i;
+	uint k;
+	SetWord word;
+	const SetWord *previous = NULL;
+	const SetWord *sourceSet;
+
+	for (k = 0; k < numProblems; ++k)
+	{
+		sourceSet = problems[k]->optimalSourceSetIndicator;
+		for (i = 0; i < numWords; ++i)
 		{
-			if (sinkAdjacentArcIndices[newIndexFrom] == -1)
+			word = sourceSet[i] & ~(previous != NULL ? previous[i] : 0);
+			while (word != 0)
 			{
-				sinkAdjacentArcIndices[newIndexFrom] = currentArc;
-				copyArcNew(problem, nodeMap, &arcListProblem[i], &problem->arcList[currentArc], lambdaValue);
-				++currentArc;
+				setJoinEntry(ctx, (uint) (i * SET_WORD_BITS + lowestBit(word)), problems[k]->entry);
+				word &= word - 1;
 			}
-			else
-			{
-				copyArcAdd(&arcListProblem[i], &problem->arcList[sinkAdjacentArcIndices[newIndexFrom]], lambdaValue);
-			}
-		}
-		else
-		{
-			copyArcNew(problem, nodeMap, &arcListProblem[i], &problem->arcList[currentArc], lambdaValue);
-			++currentArc;
 		}
+		previous = sourceSet;
 	}
-
-	/* set number of arcs */
-	problem->numArcs = currentArc;
-
-
-
 }
 
-static void initializeParametricCut(CutProblem *lowProblem, CutProblem *highProblem)
+static uint * collectFreeNodes(HpfContext *ctx, uint highEntry, uint *numFreeNodes)
 /*************************************************************************
-initializeParametricCut - Set up data structures for parametric cut
+collectFreeNodes - Free nodes of the open interval below the chain entry
+highEntry, in increasing order: the nodes that join the source set there
 *************************************************************************/
 {
-	// disable contraction by passing dummy low/high problem solutions.
-    if (all_sink==NULL && (all_sink = (char *)malloc(numNodesSuper *  sizeof(char))) == NULL)
+	uint node, count = 0;
+	uint *freeNodes;
+
+	for (node = 0; node < ctx->numNodesSuper; ++node)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		count += joinEntry(ctx, node) == highEntry;
 	}
-	if (all_source==NULL && (all_source = (char *)malloc(numNodesSuper  *sizeof(char))) == NULL )
+	freeNodes = (uint *)trackedMalloc(ctx, (count + 1) * sizeof(uint));
+	*numFreeNodes = 0;
+	for (node = 0; node < ctx->numNodesSuper && *numFreeNodes < count; ++node)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		if (joinEntry(ctx, node) == highEntry)
+		{
+			freeNodes[(*numFreeNodes)++] = node;
+		}
 	}
-  for (uint i = 0; i < numNodesSuper; i++)
-  {
-      all_sink[i] = 0;
-      all_source[i] = 1;
-  }
+	return freeNodes;
+}
 
-  /* initialize problem for LAMBDA_LOW */
-  initializeContractedProblem(lowProblem, nodeListSuper, numNodesSuper,
-		arcListSuper, numArcsSuper,LAMBDA_LOW, all_sink, all_source, 0);
+static void pushFullInterval(HpfContext *ctx, CutProblem *low, CutProblem *high, Breakpoint *position)
+/*************************************************************************
+pushFullInterval - Queue the interval between two problems in the chain
+solved on the full graph, whose free nodes are the difference of their
+source sets, unless they have the same source set
+*************************************************************************/
+{
+	uint numFreeNodes = high->sourceSetSize > low->sourceSetSize ? high->sourceSetSize - low->sourceSetSize : 0;
+	uint *freeNodes;
 
-	if (useParametricCut == 1)
+	if (numFreeNodes == 0)
 	{
-		/* initialize problem for LAMBDA_HIGH */
-		initializeContractedProblem(highProblem, nodeListSuper, numNodesSuper,
-			arcListSuper, numArcsSuper,LAMBDA_HIGH, all_sink, all_source, 1);
+		return;
 	}
 
-    free(all_sink);
-    all_sink = NULL;
+	freeNodes = (uint *)trackedMalloc(ctx, (numFreeNodes + 1) * sizeof(uint));
+	numFreeNodes = sourceSetDifference(ctx, low->optimalSourceSetIndicator, high->optimalSourceSetIndicator,
+		freeNodes);
+	pushInterval(ctx, low, high, freeNodes, numFreeNodes, position);
+}
+
+static CutProblem * solvePoint(HpfContext *ctx, const Lambda lambdaValue, int saveArcs)
+/*************************************************************************
+solvePoint - Solve the full graph at lambdaValue. Returns the problem with
+the minimal source set and its cut function.
+*************************************************************************/
+{
+	CutProblem *problem = createProblem(ctx);
+
+	initializeContractedProblem(ctx, problem, NULL, 0, lambdaValue, NONE, NONE);
+	if (saveArcs && ctx->warmStart)
+		problem->saturatedArcs = allocateArcBits(ctx);
 
-    free(all_source);
-    all_source = NULL;
+	solveProblem(ctx, problem, NULL, NULL);
+	destroyProblem(ctx, problem);
+
+	evaluateCutFunction(ctx, problem);
+	return problem;
 }
 
-static void addBreakpoint(double lambdaValue, char *sourceSetIndicator)
+static CutProblem * chainEndpoint(HpfContext *ctx, const Lambda lambdaValue, const uint entry, uint maximalSet)
 /*************************************************************************
-addBreakpoint - Adds a breakpoint to the linkedlist
+chainEndpoint - Endpoint of a deferred interval, built from its entry in
+the chain without a solve. The chain holds its source set, the cut
+function is evaluated on it. It has no warm start arcs, so the problems of
+the interval start cold.
 *************************************************************************/
 {
-	Breakpoint *newBreakpoint;
-	uint i;
+	CutProblem *problem = createProblem(ctx);
+	SetWord *sourceSet;
+	uint node;
 
+	initializeDerivedProblem(problem, lambdaValue);
+	problem->maximalSet = maximalSet;
+	problem->entry = entry;
+	problem->solved = 1;
 
-	/* allocate memory for breakpoint*/
-	if ((newBreakpoint= (Breakpoint*)malloc(sizeof(Breakpoint))) == NULL)
+	sourceSet = allocateSourceSet(ctx, problem, problem);
+	for (node = 0; node < ctx->numNodesSuper; ++node)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		assignSourceSet(sourceSet, node, node == ctx->sourceSuper
+			|| (node != ctx->sinkSuper && joinsBy(ctx, joinEntry(ctx, node), entry)));
 	}
+	evaluateCutFunction(ctx, problem);
+	freeSourceSet(ctx, problem);
+	return problem;
+}
 
-	time( &rawtime );
-	info = localtime( &rawtime );
-  printf("c Found %d breakpoint with lambda = %lf at %s\n", ++numBreakpoints, lambdaValue, asctime(info));  fflush(stdout);
-	/* assign values */
-	newBreakpoint->lambdaValue = lambdaValue;
-	newBreakpoint->next = NULL;
+static void processInterval(HpfContext *ctx, Interval *interval)
+/*************************************************************************
+processInterval - Solve the problem at the intersection of the cut
+functions of the endpoints of an interval, record a breakpoint and queue
+the subintervals on both sides of the intersection
+*************************************************************************/
+{
+    CutProblem *lowProblem = interval->low;
+    CutProblem *highProblem = interval->high;
+    uint i, node;
+    uint numLower, numUpper;
+    uint *lowerFreeNodes = NULL;
+    uint *upperFreeNodes = NULL;
+    Breakpoint *position = interval->position;
+    Breakpoint *lowerPosition = NULL;
+    Breakpoint *upperPosition = NULL;
+    Breakpoint *breakpoint = NULL;
+    int atKink = 0;
+
+    // the source sets are nested, so they differ in the difference of their sizes
+    uint num_nodes_different_low_high = highProblem->sourceSetSize > lowProblem->sourceSetSize ?
+			highProblem->sourceSetSize - lowProblem->sourceSetSize : 0;
+		printf("OG Number of nodes in different sides between the low and high problems %d\n", num_nodes_different_low_high);
 
-	/* assign space for cut */
-    /*
-	if ((newBreakpoint->sourceSetIndicator = (uint*)malloc(numNodesSuper * sizeof(uint))) == NULL)
+	/* find lambda value for which the optimal cut functions(expressed as a function of lambda)
+	for the lower bound and upper bound problem intersect. */
+	if (num_nodes_different_low_high == 0)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		return;
 	}
-    */
 
-	/* copy cut */
-	for (i = 0; i < numNodesSuper; i++)
-	{
-		//newBreakpoint->sourceSetIndicator[i] = sourceSetIndicator[i];
-        if ( sourceSetIndicator[i] && nodeBreakpoints[i] > lambdaValue )
+        printf("OG find intersection using method outlined in Hochbaum 2003 on inverse spanning-tree.\n");
+				printf("OG cut function low %lf + %lf lambda high %lf + %lf lambda\n",
+					(double) lowProblem->cutConstant, (double) lowProblem->cutMultiplier,
+					(double) highProblem->cutConstant, (double) highProblem->cutMultiplier);
+
+        Lambda lambdaIntersect = ctx->roundNegativeCapacity
+            ? roundedIntersect(ctx, lowProblem, highProblem, interval->freeNodes, interval->numFreeNodes, &atKink)
+            : computeIntersect(ctx, lowProblem, highProblem);
+				printf("OG lambdaIntersect: %lf\n", lambdaToDouble(lambdaIntersect));
+
+        // the cut functions cross inside the interval, only floating point error can move the intersection out
+        if (lambdaCompare(lambdaIntersect, lowProblem->lambdaValue) < 0)
+            lambdaIntersect = lowProblem->lambdaValue;
+        if (lambdaCompare(lambdaIntersect, highProblem->lambdaValue) > 0)
+            lambdaIntersect = highProblem->lambdaValue;
+
+        // find minimal and maximal source set at lambdaIntersect with a single solve.
+        CutProblem *minimalIntersect = createProblem(ctx);
+        initializeContractedProblem(ctx, minimalIntersect, interval->freeNodes, interval->numFreeNodes,
+					lambdaIntersect, lowProblem->entry, highProblem->entry);
+        // the minimal problem is the upper end of the lower subinterval
+        minimalIntersect->warmStartArcs = highProblem->saturatedArcs;
+        if (ctx->warmStart)
+            minimalIntersect->saturatedArcs = allocateArcBits(ctx);
+
+        // the maximal problem shares the graph and the run of the minimal problem
+        CutProblem *maximalIntersect = createProblem(ctx);
+        initializeDerivedProblem(maximalIntersect, lambdaIntersect);
+        maximalIntersect->maximalSet = 1;
+
+        solveProblem(ctx, minimalIntersect, maximalIntersect, NULL);
+
+        // both source sets contain the source set of lowProblem and differ from it in free nodes of minimalIntersect
+        deriveCutFunction(ctx, minimalIntersect, lowProblem, minimalIntersect);
+        deriveCutFunction(ctx, minimalIntersect, lowProblem, maximalIntersect);
+
+        /* the source sets of lowProblem and highProblem cut the same at the
+        intersection. Either both are optimal there, or neither is and the
+        source sets at the intersection are strictly between them. A maximal
+        source set equal to the one of lowProblem, or a minimal one equal to
+        the one of highProblem, is a tie missed by rounding the capacities:
+        the intersection is the only breakpoint of the interval then. */
+        if (!atKink && (maximalIntersect->sourceSetSize == lowProblem->sourceSetSize
+            || minimalIntersect->sourceSetSize == highProblem->sourceSetSize))
         {
-            nodeBreakpoints[i] = lambdaValue;
-						printf("c node %d is in the breakpoint\n", i);
+            for (i = 2; i < minimalIntersect->numNodesInList; ++i)
+            {
+                assignSourceSet(minimalIntersect->optimalSourceSetIndicator, i - 2, 0);
+                assignSourceSet(maximalIntersect->optimalSourceSetIndicator, i - 2, 1);
+            }
+            deriveCutFunction(ctx, minimalIntersect, lowProblem, minimalIntersect);
+            deriveCutFunction(ctx, minimalIntersect, lowProblem, maximalIntersect);
         }
-	}
+        addIntersectEntries(ctx, lowProblem, highProblem, minimalIntersect, maximalIntersect);
 
-	/* add breakpoint to linkedlist */
-	if (lastBreakpoint == NULL)
+        /* at a kink the maximal source set holds nodes that stay indifferent
+        above it, so the upper subinterval starts from the minimal one and
+        the breakpoints at the kink are left to it. So it does when the
+        nodes between the source sets are indifferent around the intersection. */
+        int joins = !atKink && joinsAtIntersect(ctx, lowProblem, highProblem, minimalIntersect, maximalIntersect);
+        CutProblem *upperLow = joins ? maximalIntersect : minimalIntersect;
+
+        if (joins)
+        {
+            // Intersection is a breakpoint
+            breakpoint = addBreakpoint(ctx, position, lambdaToDouble(lambdaIntersect), minimalIntersect);
+
+        }
+
+        /* A subinterval whose cuts equal the cuts of this interval would be
+        solved forever. The source sets are nested, so equal sizes mean equal sets. */
+        numLower = 0;
+        if (atKink || minimalIntersect->sourceSetSize != highProblem->sourceSetSize)
+            numLower = minimalIntersect->sourceSetSize - lowProblem->sourceSetSize;
+        numUpper = 0;
+        if (atKink || upperLow->sourceSetSize != lowProblem->sourceSetSize)
+            numUpper = highProblem->sourceSetSize - upperLow->sourceSetSize;
+
+        /* split the free nodes of the interval between the subintervals, and
+        move the nodes that join the source set at the intersection down the chain */
+        if (numLower > 0)
+            lowerFreeNodes = (uint *)trackedMalloc(ctx, (numLower + 1) * sizeof(uint));
+        if (numUpper > 0)
+            upperFreeNodes = (uint *)trackedMalloc(ctx, (numUpper + 1) * sizeof(uint));
+        numLower = 0;
+        numUpper = 0;
+        for (i = 2; i < minimalIntersect->numNodesInList; ++i)
+        {
+            node = minimalIntersect->nodeInfo[i].originalIndex;
+            if (inSourceSet(minimalIntersect->optimalSourceSetIndicator, i - 2))
+            {
+                setJoinEntry(ctx, node, minimalIntersect->entry);
+                if (lowerFreeNodes != NULL)
+                    lowerFreeNodes[numLower++] = node;
+            }
+            else if (joins && inSourceSet(maximalIntersect->optimalSourceSetIndicator, i - 2))
+            {
+                setJoinEntry(ctx, node, maximalIntersect->entry);
+            }
+            else if (upperFreeNodes != NULL)
+            {
+                upperFreeNodes[numUpper++] = node;
+            }
+        }
+        destroyProblem(ctx, minimalIntersect);
+        destroyProblem(ctx, maximalIntersect);
+        freeSourceSet(ctx, minimalIntersect);
+        freeSourceSet(ctx, maximalIntersect);
+
+        /* the lower subinterval is output first, in front of the breakpoint
+        at the intersection, and the upper one behind it. Depth first solves
+        the lower subinterval first as well. */
+        if (lowerFreeNodes != NULL)
+        {
+            lowerPosition = addPlaceholder(ctx, position);
+        }
+        if (upperFreeNodes != NULL)
+        {
+            upperPosition = addPlaceholder(ctx, breakpoint != NULL ? breakpoint
+                : lowerPosition != NULL ? lowerPosition : position);
+        }
+        if (ctx->breadthFirst && lowerFreeNodes != NULL)
+            pushInterval(ctx, lowProblem, minimalIntersect, lowerFreeNodes, numLower, lowerPosition);
+        if (upperFreeNodes != NULL)
+            pushInterval(ctx, upperLow, highProblem, upperFreeNodes, numUpper, upperPosition);
+        if (!ctx->breadthFirst && lowerFreeNodes != NULL)
+            pushInterval(ctx, lowProblem, minimalIntersect, lowerFreeNodes, numLower, lowerPosition);
+
+        releaseProblem(ctx, minimalIntersect);
+        releaseProblem(ctx, maximalIntersect);
+}
+
+static void resetContext(HpfContext *ctx)
+/*************************************************************************
+resetContext - Reset the solver state of a context before a new solve
+*************************************************************************/
+{
+	ctx->numNodes = 0;
+	ctx->numArcs = 0;
+	ctx->numNodesSuper = 0;
+	ctx->numArcsSuper = 0;
+	ctx->source = 0;
+	ctx->sink = 0;
+	ctx->highestStrongLabel = 1;
+
+	ctx->numBreakpoints = 0;
+	ctx->numArcScans = 0;
+	ctx->numPushes = 0;
+	ctx->numMergers = 0;
+	ctx->numRelabels = 0;
+	ctx->numGaps = 0;
+
+	ctx->nodesList = NULL;
+	ctx->strongRoots = NULL;
+	ctx->labelCount = NULL;
+	ctx->arcList = NULL;
+	ctx->nodeListSuper = NULL;
+	ctx->arcListSuper = NULL;
+	ctx->superIncidenceOffsets = NULL;
+	ctx->superIncidentArcs = NULL;
+	ctx->lowestPositiveExcessNode = 0;
+
+	ctx->nodeBreakpoints = NULL;
+
+	ctx->lastBreakpoint = NULL;
+	ctx->firstBreakpoint = NULL;
+
+	ctx->useParametricCut = 1;
+	ctx->roundNegativeCapacity = 0;
+	ctx->warmStartArcs = NULL;
+
+	ctx->intervalsHead = 0;
+	ctx->numIntervals = 0;
+	ctx->numMaterializedIntervals = 0;
+	ctx->maxQueueDepth = 0;
+	ctx->endpointOverlap = 0;
+	ctx->error = HPF_OK;
+
+	ctx->LAMBDA_LOW = lambdaFromDouble(0);
+	ctx->LAMBDA_HIGH = lambdaFromDouble(0);
+
+	/* the arena limit, warm start, free runs, interval order and cap, the number of threads, the seeds, the parallel pseudoflow size, the region size and the edge mode are settings of the context and survive a reset */
+    freeCaches(ctx);
+	arenaFree(&ctx->arena);
+	ctx->arena.outside = 0;
+	ctx->arena.highWater = 0;
+}
+
+static void * solveIntervals(void *arg)
+/*************************************************************************
+solveIntervals - Take intervals from the queue of the root context and
+process them, until the queue is empty and no busy worker can add to it.
+The body of a worker thread, and of the serial parametric cut. A worker
+that exceeds the arena limit sets the error of root, and all workers stop
+at their next interval. The intervals left are freed by the caller.
+*************************************************************************/
+{
+	HpfContext *ctx = (HpfContext *) arg;
+	HpfContext *root = ctx->root;
+	Interval interval;
+	jmp_buf unwind;
+	jmp_buf *outer = ctx->arena.unwind;
+
+	ctx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
 	{
-		/* initialize list */
-		firstBreakpoint = newBreakpoint;
-		lastBreakpoint = newBreakpoint;
+		lockShared(ctx);
+		root->error = ctx->arena.error;
+		--root->numBusyWorkers;
+		if (root->numWorkers > 0)
+		{
+			pthread_cond_broadcast(&root->workChanged);
+		}
+		unlockShared(ctx);
+		ctx->arena.unwind = outer;
+		return NULL;
 	}
-	else
+
+	lockShared(ctx);
+	while (1)
 	{
-		/* add new element to linked list*/
-		lastBreakpoint->next = newBreakpoint;
-		/* update head */
-		lastBreakpoint = newBreakpoint;
+		while (root->numIntervals == 0 && root->numBusyWorkers > 0 && root->error == HPF_OK)
+		{
+			pthread_cond_wait(&root->workChanged, &root->lock);
+		}
+		if (root->numIntervals == 0 || root->error != HPF_OK)
+		{
+			break;
+		}
+
+		popInterval(root, &interval);
+		++root->numBusyWorkers;
+		unlockShared(ctx);
+
+		if (interval.low == NULL)
+		{
+			// deferred interval: the chain still holds its endpoints, its free nodes join the source set at its upper end
+			interval.low = chainEndpoint(ctx, interval.lowLambda, interval.lowEntry, interval.lowMaximal);
+			interval.high = chainEndpoint(ctx, interval.highLambda, interval.highEntry, interval.highMaximal);
+			interval.freeNodes = collectFreeNodes(ctx, interval.highEntry, &interval.numFreeNodes);
+		}
+
+		processInterval(ctx, &interval);
+
+		trackedFree(ctx, interval.freeNodes, (interval.numFreeNodes + 1) * sizeof(uint));
+		releaseProblem(ctx, interval.low);
+		releaseProblem(ctx, interval.high);
+
+		lockShared(ctx);
+		--root->numBusyWorkers;
+		if (root->numBusyWorkers == 0 && root->numIntervals == 0 && root->numWorkers > 0)
+		{
+			pthread_cond_broadcast(&root->workChanged);
+		}
 	}
-}/*addBreakpoint*/
+	unlockShared(ctx);
 
-static void createMemoryStructures( )
+	ctx->arena.unwind = outer;
+	return NULL;
+}
+
+static HpfContext * createWorker(HpfContext *ctx)
 /*************************************************************************
-createMemoryStructures - creates memory structures
+createWorker - Context for a worker thread that shares the super graph
+of ctx and has its own solve state, arena and caches, or NULL
 *************************************************************************/
 {
-	uint from;
-	uint to;
-	uint i;
-	double capacity;
+	HpfContext *worker;
 
-	/* create memory structures */
-	for (i=0; i<numNodes; ++i)
+	if ((worker = (HpfContext *)calloc(1, sizeof(HpfContext))) == NULL)
 	{
-		createOutOfTree(&nodesList[i]);
+		return NULL;
 	}
 
-	for (i=0; i<numArcs; i++)
+	worker->root = ctx;
+	resetContext(worker);
+
+	worker->numNodesSuper = ctx->numNodesSuper;
+	worker->numArcsSuper = ctx->numArcsSuper;
+	worker->sourceSuper = ctx->sourceSuper;
+	worker->sinkSuper = ctx->sinkSuper;
+	worker->nodeListSuper = ctx->nodeListSuper;
+	worker->arcListSuper = ctx->arcListSuper;
+	worker->superIncidenceOffsets = ctx->superIncidenceOffsets;
+	worker->superIncidentArcs = ctx->superIncidentArcs;
+	worker->useParametricCut = ctx->useParametricCut;
+	worker->roundNegativeCapacity = ctx->roundNegativeCapacity;
+	worker->warmStart = ctx->warmStart;
+	worker->parallelPseudoflowNodes = ctx->parallelPseudoflowNodes;
+	worker->regionNodes = ctx->regionNodes;
+	worker->undirected = ctx->undirected;
+	worker->LAMBDA_LOW = ctx->LAMBDA_LOW;
+	worker->LAMBDA_HIGH = ctx->LAMBDA_HIGH;
+	worker->arena.shared = &ctx->arena;
+	worker->arena.sharedLock = &ctx->lock;
+	return worker;
+}
+
+static void destroyWorker(HpfContext *ctx, HpfContext *worker)
+/*************************************************************************
+destroyWorker - Add the work of a worker to ctx and release its own
+memory
+*************************************************************************/
+{
+	ctx->numArcScans += worker->numArcScans;
+	ctx->numMergers += worker->numMergers;
+	ctx->numPushes += worker->numPushes;
+	ctx->numRelabels += worker->numRelabels;
+	ctx->numGaps += worker->numGaps;
+
+	freeCaches(worker);
+	arenaFree(&worker->arena);
+	free(worker);
+}
+
+static void runWorkers(HpfContext *ctx, uint numThreads, void * (*body)(void *))
+/*************************************************************************
+runWorkers - Run body on numThreads worker contexts of ctx in parallel.
+The calling thread waits for them, the workers share the state of ctx.
+The workers whose thread could not be created do nothing, the calling
+thread runs the first one itself if none could. Running out of memory for
+the workers unwinds ctx.
+*************************************************************************/
+{
+	HpfContext **workers;
+	pthread_t *threads;
+	uint i, numStarted;
+
+	if ((workers = (HpfContext **)calloc(numThreads, sizeof(HpfContext *))) == NULL ||
+		(threads = (pthread_t *)malloc(numThreads * sizeof(pthread_t))) == NULL)
 	{
-		to = arcList[i].to->number;
-		from = arcList[i].from->number;
-		capacity = arcList[i].capacity;
+		free(workers);
+		arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
+	}
 
-		if (!((source == to) || (sink == from) || (from == to)))
+	for (i = 0; i < numThreads; ++i)
+	{
+		if ((workers[i] = createWorker(ctx)) == NULL)
 		{
-			if ((source == from) && (to == sink))
+			for (i = 0; i < numThreads && workers[i] != NULL; ++i)
 			{
-				arcList[i].flow = capacity;
-			} else if (to == sink) {
-				addOutOfTreeNode(&nodesList[to], &arcList[i]);
-			} else {
-				addOutOfTreeNode(&nodesList[from], &arcList[i]);
+				destroyWorker(ctx, workers[i]);
 			}
+			free(workers);
+			free(threads);
+			arenaRaise(&ctx->arena, HPF_ERROR_OUT_OF_MEMORY);
 		}
+		// threads not running a worker help with the arc passes and pseudoflow runs of the workers
+		workers[i]->spareThreads = ctx->numThreads > numThreads ? ctx->numThreads / numThreads : 1;
 	}
 
-	/* allocate memory for root and label count */
-	if ((strongRoots = (Root *)malloc(numNodes * sizeof(Root))) == NULL)
+	ctx->numWorkers = numThreads;
+	for (numStarted = 0; numStarted < numThreads; ++numStarted)
+	{
+		if (pthread_create(&threads[numStarted], NULL, body, workers[numStarted]) != 0)
+		{
+			break;
+		}
+	}
+	if (numStarted == 0)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		body(workers[0]);
 	}
-	if ((labelCount = (uint *)malloc(numNodes * sizeof(uint))) == NULL)
+	for (i = 0; i < numStarted; ++i)
 	{
-		printf("Could not allocate memory.\n");
-		exit(0);
+		pthread_join(threads[i], NULL);
 	}
+	ctx->numWorkers = 0;
 
-	/* Initialization of root & labelcount */
-	for (i = 0; i<numNodes; ++i)
+	for (i = 0; i < numThreads; ++i)
 	{
-		initializeRoot(&strongRoots[i]);
-		labelCount[i] = 0;
+		destroyWorker(ctx, workers[i]);
 	}
+	free(workers);
+	free(threads);
 }
 
-static void evaluateCut(CutProblem *problem)
+static void solveQueue(HpfContext *ctx)
 /*************************************************************************
-evaluateCut - Evaluates optimal cut parameters for a given problem
+solveQueue - Solve the open intervals in the queue. With several threads,
+workers take intervals from the queue while the calling thread waits. The
+breakpoints of an interval go behind its placeholder, so the output does
+not depend on the order the workers finish in. The error of a worker
+unwinds ctx.
 *************************************************************************/
 {
-	uint i;
-	int originalIndexFrom;
-	int originalIndexTo;
-	for (i = 0; i < problem->numArcs; ++i)
+	if (ctx->numThreads <= 1)
 	{
-		originalIndexFrom = problem->arcList[i].from->originalIndex;
-		originalIndexTo = problem->arcList[i].to->originalIndex;
-		if ((originalIndexFrom == -1 || problem->optimalSourceSetIndicator[originalIndexFrom] == 1) && (originalIndexTo == -2 || problem->optimalSourceSetIndicator[originalIndexTo] == 0 ) )
-		{
-		  problem->cutValue += problem->arcList[i].capacity;
-		}
+		solveIntervals(ctx);
+	}
+	else
+	{
+		runWorkers(ctx, ctx->numThreads, solveIntervals);
+	}
+	if (ctx->error != HPF_OK)
+	{
+		arenaRaise(&ctx->arena, ctx->error);
 	}
 }
 
-static void solveProblem(CutProblem *problem, uint maximalSourceSet)
+static void parametricCut(HpfContext *ctx, CutProblem *lowProblem, CutProblem *highProblem)
 /*************************************************************************
-solveProblem - solves a single instance of cut problem
+parametricCut - Solve the parametric cut problem between two problems
+solved on the full graph. Open intervals are kept in a queue instead of on
+the call stack and solved depth first or breadth first.
 *************************************************************************/
 {
-	uint i;
-	char *tempSourceSet;
-	uint nodeCount;
-
-	nodesList = problem->nodeList;
-	numNodes = problem->numNodesInList;
-	numArcs = problem->numArcs;
-	problem->cutValue = 0.0;
-
-    // reset some globals
-    highestStrongLabel = 1;
-	lowestPositiveExcessNode = 0;
-
+	CutProblem *bounds[2];
+
+	lowProblem->entry = addChainEntry(ctx, lowProblem->lambdaValue, 1.0 / 3);
+	highProblem->entry = addChainEntry(ctx, highProblem->lambdaValue, 1.0 / 3);
+	bounds[0] = lowProblem;
+	bounds[1] = highProblem;
+	joinChain(ctx, bounds, 2);
+
+	pushFullInterval(ctx, lowProblem, highProblem, addPlaceholder(ctx, NULL));
+	freeSourceSet(ctx, lowProblem);
+	freeSourceSet(ctx, highProblem);
+	solveQueue(ctx);
+}
 
-	// handle empty problems
-	if (numNodes == 2)
+static uint chooseSeeds(HpfContext *ctx, Lambda *seeds)
+/*************************************************************************
+chooseSeeds - Up to numSeeds increasing lambda values strictly inside the
+lambda range. They are evenly spaced, or quantiles of the lambda values at
+which the terminal arcs of a node balance, the value at which the node
+would join the source set without its other arcs.
+*************************************************************************/
+{
+	uint i, numRatios, numSeeds;
+	Arc *arc;
+	Capacity *terminalConstant;
+	Capacity *terminalMultiplier;
+	Lambda *ratios;
+	ArenaMark scratch = arenaMark(&ctx->arena);
+
+	if (!ctx->seedFromRatios)
 	{
-		/* assign nodes to source / sink set */
-		if ((problem->optimalSourceSetIndicator = (char *)malloc(numNodesSuper * sizeof(char))) == NULL)
+		for (i = 0; i < ctx->numSeeds; ++i)
 		{
-			printf("Out of memory\n");
-			exit(0);
+			seeds[i] = lambdaBetween(ctx->LAMBDA_LOW, ctx->LAMBDA_HIGH, i + 1, ctx->numSeeds + 1);
 		}
-
-		for (i = 0; i < problem->numSourceSet; i++)
+		numRatios = ctx->numSeeds;
+	}
+	else
+	{
+		/* net capacity of the sink arcs minus the source arcs of every node */
+		terminalConstant = (Capacity *)arenaAlloc(&ctx->arena, ctx->numNodesSuper * sizeof(Capacity));
+		terminalMultiplier = (Capacity *)arenaAlloc(&ctx->arena, ctx->numNodesSuper * sizeof(Capacity));
+		ratios = (Lambda *)arenaAlloc(&ctx->arena, ctx->numNodesSuper * sizeof(Lambda));
+		memset(terminalConstant, 0, ctx->numNodesSuper * sizeof(Capacity));
+		memset(terminalMultiplier, 0, ctx->numNodesSuper * sizeof(Capacity));
+
+		for (i = 0; i < ctx->numArcsSuper; ++i)
 		{
-			problem->optimalSourceSetIndicator[problem->sourceSet[i].originalIndex] = 1;
+			arc = &ctx->arcListSuper[i];
+			if (arc->from == ctx->sourceSuper && arc->to != ctx->sinkSuper)
+			{
+				terminalConstant[arc->to] -= arc->constant;
+				terminalMultiplier[arc->to] -= arc->multiplier;
+			}
+			else if (arc->to == ctx->sinkSuper && arc->from != ctx->sourceSuper)
+			{
+				terminalConstant[arc->from] += arc->constant;
+				terminalMultiplier[arc->from] += arc->multiplier;
+			}
 		}
 
-		for (i = 0; i < problem->numSinkSet; i++)
+		numRatios = 0;
+		for (i = 0; i < ctx->numNodesSuper; ++i)
 		{
-			problem->optimalSourceSetIndicator[problem->sinkSet[i].originalIndex] = 0;
+			if (terminalMultiplier[i] < 0)
+			{
+				ratios[numRatios++] = lambdaRatio(terminalConstant[i], - terminalMultiplier[i]);
+			}
 		}
+		qsort(ratios, numRatios, sizeof(Lambda), cmpLambda);
 
-		/* determine cut value */
-		for (i = 0; i < problem->numArcs; i++)
+		for (i = 0; i < ctx->numSeeds && numRatios > 0; ++i)
 		{
-			if (problem->arcList[i].from->originalIndex == -1 && problem->arcList[i].to->originalIndex == -2)
-			{
-				problem->cutValue += problem->arcList[i].capacity;
-			}
+			seeds[i] = ratios[(size_t) numRatios * (i + 1) / (ctx->numSeeds + 1)];
 		}
+		numRatios = i;
+	}
 
-        problem->solved =1;
-		return;
+	/* drop seeds outside of the lambda range and repeated seeds */
+	numSeeds = 0;
+	for (i = 0; i < numRatios; ++i)
+	{
+		if (lambdaCompare(seeds[i], numSeeds > 0 ? seeds[numSeeds - 1] : ctx->LAMBDA_LOW) > 0
+			&& lambdaCompare(seeds[i], ctx->LAMBDA_HIGH) < 0)
+		{
+			seeds[numSeeds++] = seeds[i];
+		}
 	}
 
+	arenaRelease(&ctx->arena, scratch);
+	return numSeeds;
+}
 
-	if (maximalSourceSet == 1)
+static void * solvePoints(void *arg)
+/*************************************************************************
+solvePoints - Solve the points of the root context until none is left.
+The body of a worker thread, and of the serial solve. Like solveIntervals,
+the workers stop at the error of one of them.
+*************************************************************************/
+{
+	HpfContext *ctx = (HpfContext *) arg;
+	HpfContext *root = ctx->root;
+	SeedPoint *point;
+	jmp_buf unwind;
+	jmp_buf *outer = ctx->arena.unwind;
+
+	ctx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
 	{
-		source = 1;
-		sink = 0;
+		lockShared(ctx);
+		root->error = ctx->arena.error;
+		unlockShared(ctx);
+		ctx->arena.unwind = outer;
+		return NULL;
+	}
 
-		/* allocate space for reversed arcs */
-		if ((arcList = (Arc *)malloc(numArcs * sizeof(Arc))) == NULL)
+	while (1)
+	{
+		lockShared(ctx);
+		point = root->error == HPF_OK && root->nextPoint < root->numPoints ? &root->points[root->nextPoint++] : NULL;
+		unlockShared(ctx);
+		if (point == NULL)
 		{
-			printf("Out of memory\n");
-			exit(0);
+			break;
 		}
 
-		/* copy arcs such that arcs can be reversed */
-		for (i = 0; i < numArcs; i++)
-		{
-			/* initialize new arc*/
-			initializeArc(&arcList[i]);
+		point->start = wallClock();
+		point->minimal = solvePoint(ctx, point->lambdaValue, point->saveArcs);
+		point->end = wallClock();
+	}
+	ctx->arena.unwind = outer;
+	return NULL;
+}
 
-			// reverse direction
-			arcList[i].from = problem->arcList[i].to;
-			arcList[i].to = problem->arcList[i].from;
+static int useSeedPoints(HpfContext *ctx)
+/*************************************************************************
+useSeedPoints - Whether the lower and upper bound problems are solved as
+points of seededParametricCut: with seeds, or when they can be solved at
+the same time. A free run solves the upper bound problem from the lower
+one, so the two cannot overlap without seeds.
+*************************************************************************/
+{
+	return ctx->useParametricCut == 1 && (ctx->numSeeds > 0 || (ctx->numThreads > 1 && !useFreeRuns(ctx)));
+}
 
-			// assign capacity
-			arcList[i].capacity = problem->arcList[i].capacity;
-		}
+static void seededParametricCut(HpfContext *ctx, CutProblem **lowProblem, CutProblem **highProblem)
+/*************************************************************************
+seededParametricCut - Solve the bounds of the lambda range and the seeds
+between them, in parallel with several threads, and queue the intervals
+between the minimal source sets of consecutive points at once. Minimal
+source sets are nested, maximal ones are not: a node that is indifferent
+at every lambda is in every maximal source set and in no minimal one. So
+whether a seed is a breakpoint is left to the interval above it, whose
+intersection falls on the seed then (see processInterval).
+The breakpoints are output by interval in increasing order of the seeds.
+*************************************************************************/
+{
+	uint i, numSeeds, numPoints;
+	Lambda *seeds;
+	CutProblem **chain;
+	SeedPoint *points;
+	CutProblem *low;
+	CutProblem *high;
+
+	initializeChain(ctx);
+
+	/* tracked, so an unwound solve frees them */
+	seeds = (Lambda *)trackedMalloc(ctx, (ctx->numSeeds + 1) * sizeof(Lambda));
+	points = (SeedPoint *)trackedMalloc(ctx, (ctx->numSeeds + 2) * sizeof(SeedPoint));
+	memset(points, 0, (ctx->numSeeds + 2) * sizeof(SeedPoint));
+
+	numSeeds = chooseSeeds(ctx, seeds);
+	numPoints = numSeeds + 2;
+	points[0].lambdaValue = ctx->LAMBDA_LOW;
+	for (i = 1; i <= numSeeds; ++i)
+	{
+		points[i].lambdaValue = seeds[i - 1];
+		points[i].saveArcs = 1;
 	}
-	else
+	points[numPoints - 1].lambdaValue = ctx->LAMBDA_HIGH;
+	points[numPoints - 1].saveArcs = 1;
+	trackedFree(ctx, seeds, (ctx->numSeeds + 1) * sizeof(Lambda));
+
+	/* the flows of each point warm start the problems of the interval below it */
+	ctx->points = points;
+	ctx->numPoints = numPoints;
+	ctx->nextPoint = 0;
+	if (ctx->numThreads <= 1)
 	{
-		source = 0;
-		sink = 1;
-
-		arcList = problem->arcList;
+		solvePoints(ctx);
 	}
-
-	// solve
-	createMemoryStructures();
-	simpleInitialization();
-	pseudoflowPhase1();
-
-	/* allocate memory for source set (possibly reversed) */
-	nodeCount = problem->numNodesInList + problem->numSourceSet + problem->numSinkSet - 2;
-	if ((tempSourceSet = (char *)malloc(nodeCount * sizeof(char))) == NULL)
+	else
 	{
-		printf("Out of memory\n");
-		exit(0);
+		runWorkers(ctx, ctx->numThreads < numPoints ? ctx->numThreads : numPoints, solvePoints);
+		ctx->endpointOverlap = math_max(0, math_min(points[0].end, points[numPoints - 1].end)
+			- math_max(points[0].start, points[numPoints - 1].start));
+	}
+	ctx->points = NULL;
+	ctx->numPoints = 0;
+	if (ctx->error != HPF_OK)
+	{
+		arenaRaise(&ctx->arena, ctx->error);
 	}
 
-	// retrieve optimal sourceSet for nodes in graph
-	if (maximalSourceSet == 1) // reverse assignment to source and sink set
+	/* the points enter the chain in increasing order */
+	chain = (CutProblem **)trackedMalloc(ctx, numPoints * sizeof(CutProblem *));
+	for (i = 0; i < numPoints; ++i)
 	{
-		for (i = 2; i<numNodes; ++i) // start from 2 to ignore artificial source and sink
-		{
-			if (nodesList[i].label >= numNodes)
-			{
-				tempSourceSet[nodesList[i].originalIndex] = 0;
-            }
-			else
-			{
-				tempSourceSet[nodesList[i].originalIndex] = 1;
-			}
-		}
+		points[i].minimal->entry = addChainEntry(ctx, points[i].lambdaValue, 1.0 / 3);
+		chain[i] = points[i].minimal;
 	}
-	else
+	joinChain(ctx, chain, numPoints);
+
+	for (i = 0; i + 1 < numPoints; ++i)
 	{
-		for (i = 2; i<numNodes; ++i) // start from 2 to ignore artificial source and sink
+		low = points[i].minimal;
+		high = points[i + 1].minimal;
+		if (high->sourceSetSize > low->sourceSetSize)
 		{
-			if (nodesList[i].label >= numNodes)
-			{
-				tempSourceSet[nodesList[i].originalIndex] = 1;
-			}
-			else
-			{
-				tempSourceSet[nodesList[i].originalIndex] = 0;
-			}
+			pushFullInterval(ctx, low, high, addPlaceholder(ctx, NULL));
 		}
 	}
 
-	// process cut for source set nodes
-	for (i = 0; i < problem->numSourceSet; i++)
+	for (i = 0; i < numPoints; ++i)
 	{
-		tempSourceSet[problem->sourceSet[i].originalIndex] = 1;
+		freeSourceSet(ctx, chain[i]);
 	}
-	// process cut for sink set nodes
-	for (i = 0; i < problem->numSinkSet; i++)
+	trackedFree(ctx, chain, numPoints * sizeof(CutProblem *));
+
+	for (i = 1; i <= numSeeds; ++i)
 	{
-		tempSourceSet[problem->sinkSet[i].originalIndex] = 0;
+		releaseProblem(ctx, points[i].minimal);
 	}
+	*lowProblem = points[0].minimal;
+	*highProblem = points[numPoints - 1].minimal;
+	trackedFree(ctx, points, (ctx->numSeeds + 2) * sizeof(SeedPoint));
 
-	// assign cut
-	problem->optimalSourceSetIndicator = tempSourceSet;
-	evaluateCut(problem);
+	solveQueue(ctx);
+}
+
+HpfContext * hpf_context_create(void)
+/*************************************************************************
+hpf_context_create - Allocate an empty solver context, or NULL without
+the memory for it
+*************************************************************************/
+{
+	HpfContext *ctx;
 
-	if (maximalSourceSet == 1)
+	if ((ctx = (HpfContext *)calloc(1, sizeof(HpfContext))) == NULL)
 	{
-		// free if new memory has been allocated for arclist. Memory should not be freed if arcList is taken from the problem
-		free(arcList);
-		arcList = NULL;
+		return NULL;
 	}
 
-    problem->solved =1;
-
-	printCutProblem(problem);
-	// printf("lambda:%.12lf\n" ,problem->lambdaValue);
-
-	freeMemorySolve();
+	ctx->warmStart = 1;
+	ctx->freeRuns = 0;
+	ctx->root = ctx;
+	ctx->numThreads = 1;
+	pthread_mutex_init(&ctx->lock, NULL);
+	pthread_cond_init(&ctx->workChanged, NULL);
+	resetContext(ctx);
+	return ctx;
 }
 
-static void differenceSourceSets(char **ppdifference,
-	char *lowOptimalSourceIndicator, char *highOptimalSourceIndicator)
+void hpf_context_destroy(HpfContext *ctx)
+/*************************************************************************
+hpf_context_destroy - Release a solver context and its caches
+*************************************************************************/
 {
-    if (pdifferenceCache==NULL && (pdifferenceCache = (char *)malloc(numNodesSuper * sizeof(char))) == NULL)
+	if (ctx == NULL)
 	{
-		printf("Out of memory\n");
-		exit(0);
+		return;
 	}
-    *ppdifference = pdifferenceCache;
-    char *pdifference = *ppdifference;
-    for (int i = 0; i < numNodesSuper; i++)
-    {
-      pdifference[i] = highOptimalSourceIndicator[i] - lowOptimalSourceIndicator[i];
-    }
-}
 
-static double internalCutCapacity(char *optimalSourceSetIndicator) {
-    int from, to;
-    double arc_capacity;
-    double capacity = 0;
-		// printf("OG STARTING internalCutCapacity\n");
-    for (int i=0; i < numArcsSuper; i++)
-    {
-        from = arcListSuper[i].from->originalIndex;
-        to = arcListSuper[i].to->originalIndex;
-        arc_capacity = arcListSuper[i].constant;
-        if (optimalSourceSetIndicator[from] == 1
-					&& optimalSourceSetIndicator[to] == 0
-					&& from != sourceSuper) // && to != sinkSuper)
-        {
-            capacity += arc_capacity;
-						// printf("OG capacity from %d to %d is %lf\n", from, to, arc_capacity);
-        }
-    }
-		printf("OG internalCutCapacity is %lf\n", capacity);
-    return capacity;
+	freeCaches(ctx);
+	freeTracked(ctx);
+	arenaFree(&ctx->arena);
+	pthread_mutex_destroy(&ctx->lock);
+	pthread_cond_destroy(&ctx->workChanged);
+	free(ctx);
 }
 
-static double computeIntersect(char *difference, double K12)
+size_t hpf_context_arena_high_water(const HpfContext *ctx)
+/*************************************************************************
+hpf_context_arena_high_water - Peak number of bytes held in the solver
+arena (solve scratch memory) and in the source sets and warm start bits
+of the open intervals during the last solve. The arenas of the workers
+and region blocks count towards it and towards the arena limit, so with
+several threads it is the peak of the memory in use by all of them at
+the same time.
+*************************************************************************/
 {
-    double constant = K12;
-    double multiplier = 0;
-
-    for (int i = 0; i < numArcsSuper; i++)
-    {
+	return ctx->arena.highWater;
+}
 
-        if (arcListSuper[i].from->originalIndex == sourceSuper
-					&& difference[arcListSuper[i].to->originalIndex] == 1)
-        {
-            constant += arcListSuper[i].constant;
-            multiplier += arcListSuper[i].multiplier;
-        }
-        else if (arcListSuper[i].to->originalIndex == sinkSuper
-					&& difference[arcListSuper[i].from->originalIndex] == 1
-					&& roundNegativeCapacity == 0)
-        {
-            constant -= arcListSuper[i].constant;
-            multiplier -= arcListSuper[i].multiplier;
-        }
-    }
+void hpf_context_set_seeds(HpfContext *ctx, int numSeeds, int fromTerminalRatios)
+/*************************************************************************
+hpf_context_set_seeds - Solve numSeeds lambda values inside the lambda
+range together with its bounds (in parallel with several threads), and
+start the parametric cut from the intervals between them (default 0, no
+seeds). The seeds are evenly spaced, or with fromTerminalRatios quantiles
+of the lambda values at which the source and sink arcs of a node balance.
+The breakpoints and cuts do not depend on the seeds, their order in the
+output does. Free runs are not used with seeds.
+*************************************************************************/
+{
+	ctx->numSeeds = numSeeds > 0 ? (uint) numSeeds : 0;
+	ctx->seedFromRatios = fromTerminalRatios != 0;
+}
 
-    return constant / (- multiplier);
+double hpf_context_endpoint_overlap(const HpfContext *ctx)
+/*************************************************************************
+hpf_context_endpoint_overlap - Wall-clock seconds that the lower and
+upper bound problems of the last solve were set up and solved at the same
+time. 0 unless they are solved concurrently (see hpf_context_set_threads).
+*************************************************************************/
+{
+	return ctx->endpointOverlap;
 }
 
-static void parametricCut(CutProblem *lowProblem, CutProblem *highProblem)
+int hpf_context_max_queue_depth(const HpfContext *ctx)
 /*************************************************************************
-parametricCut - Recursive function that solves the parametric cut problem
+hpf_context_max_queue_depth - Peak number of open intervals of the
+parametric cut during the last solve
 *************************************************************************/
 {
+	return (int) ctx->maxQueueDepth;
+}
 
-    // determine difference between source sets of cut.
-    char *pdifference_low_high;
-    differenceSourceSets(&pdifference_low_high, lowProblem->optimalSourceSetIndicator,
-			highProblem->optimalSourceSetIndicator);
-    uint num_nodes_different_low_high = sum_array_char(pdifference_low_high,
-			numNodesSuper);
-		printf("OG Number of nodes in different sides between the low and high problems %d\n", num_nodes_different_low_high);
+void hpf_context_set_arena_limit(HpfContext *ctx, size_t limit)
+/*************************************************************************
+hpf_context_set_arena_limit - Cap the solver arena at limit bytes. The
+solve that would exceed it returns HPF_ERROR_ARENA_LIMIT. 0 disables the
+cap.
+*************************************************************************/
+{
+	ctx->arena.limit = limit;
+}
 
-	/* find lambda value for which the optimal cut functions(expressed as a function of lambda)
-	for the lower bound and upper bound problem intersect. */
-	if (num_nodes_different_low_high > 0)
-	{
-        printf("OG find intersection using method outlined in Hochbaum 2003 on inverse spanning-tree.\n");
-        double Klow = internalCutCapacity(lowProblem->optimalSourceSetIndicator);
-        double Khigh = internalCutCapacity(highProblem->optimalSourceSetIndicator);
-        double K12 = Klow - Khigh;
-				printf("OG intCutCapLow %lf intCutCapHigh %lf difference %lf\n", Klow, Khigh, K12);
-
-        double lambdaIntersect = computeIntersect(pdifference_low_high, K12);
-				// if (lambdaIntersect == oldLambdaIntersect)
-				// {
-				// 	lambdaIntersect += (LAMBDA_HIGH-lambdaIntersect)/2;
-				// }
-				// oldLambdaIntersect = lambdaIntersect;
-				printf("OG lambdaIntersect: %lf\n", lambdaIntersect);
-
-        // find minimal and maximal source set at lambdaIntersect.
-        // Add/subtract TOL to prevent numerical issues.
-        CutProblem minimalIntersect;
-        initializeContractedProblem(&minimalIntersect, nodeListSuper, numNodesSuper,
-					arcListSuper, numArcsSuper,math_max(lambdaIntersect - TOL, LAMBDA_LOW),
-					lowProblem->optimalSourceSetIndicator, highProblem->optimalSourceSetIndicator,
-                    0);
-
-        solveProblem(&minimalIntersect, 0);
-				// printf("Solved problem minimal\n");
-        destroyProblem(&minimalIntersect, 0);
-
-		    CutProblem maximalIntersect;
-        initializeContractedProblem(&maximalIntersect, nodeListSuper, numNodesSuper, arcListSuper,
-					numArcsSuper,math_min(lambdaIntersect + TOL, LAMBDA_HIGH), minimalIntersect.optimalSourceSetIndicator,
-					highProblem->optimalSourceSetIndicator, 1 );
-
-        solveProblem(&maximalIntersect, 0);
-				// printf("solved problem maximal\n");
-        destroyProblem(&maximalIntersect, 0);
-
-        // check if lambdaIntersect is a breakpoint by comparing min and max source set.
-        char *pdifference_min_max_intersect;
-
-        differenceSourceSets(&pdifference_min_max_intersect, minimalIntersect.optimalSourceSetIndicator,
-					maximalIntersect.optimalSourceSetIndicator);
-				// printf("difference soursesets\n");
-        uint num_nodes_different_min_max = sum_array_char(pdifference_min_max_intersect, numNodesSuper);
-				// if (num_nodes_different_min_max > 0){
-				//  printf("OG num_node_difference_min_max %d\n", num_nodes_different_min_max); fflush;
-				// }
-
-        if (num_nodes_different_min_max > 0 )
-        {
-            // Intersection is a breakpoint
-            addBreakpoint(lambdaIntersect, minimalIntersect.optimalSourceSetIndicator);
+void hpf_context_set_warm_start(HpfContext *ctx, int warmStart)
+/*************************************************************************
+hpf_context_set_warm_start - Start the subproblems of the parametric
+recursion from the rounded flows of the solve at the upper end of their
+interval (default 1), or from zero flow (0). The cuts do not depend on
+the setting, the work does.
+*************************************************************************/
+{
+	ctx->warmStart = warmStart != 0;
+}
 
-        }
-    		parametricCut(lowProblem, &minimalIntersect);
+void hpf_context_set_free_runs(HpfContext *ctx, int freeRuns)
+/*************************************************************************
+hpf_context_set_free_runs - Solve the upper bound problem by a free run
+that continues the solve of the lower bound problem (1), or from scratch
+(0, default). Ignored by the integer
+capacity types. The cuts do not depend on the setting, the work does.
+*************************************************************************/
+{
+	ctx->freeRuns = freeRuns != 0;
+}
 
-    		/* recurse for higher subinterval */
-    		parametricCut(&maximalIntersect, highProblem);
+void hpf_context_set_breadth_first(HpfContext *ctx, int breadthFirst)
+/*************************************************************************
+hpf_context_set_breadth_first - Solve the open intervals of the
+parametric cut in breadth first order (1), or depth first (0, default).
+The breakpoints are output in the same order for both settings.
+*************************************************************************/
+{
+	ctx->breadthFirst = breadthFirst != 0;
+}
 
+void hpf_context_set_open_interval_cap(HpfContext *ctx, int cap)
+/*************************************************************************
+hpf_context_set_open_interval_cap - Keep the source sets of at most cap
+open intervals. Further intervals keep only their lambda values and solve
+their endpoints again when they are taken from the queue, which trades
+solve time for memory. 0 disables the cap (default).
+*************************************************************************/
+{
+	ctx->openIntervalCap = cap > 0 ? (uint) cap : 0;
+}
 
-        /* call destructor function */
-        destroyProblem(&minimalIntersect, 1);
-        destroyProblem(&maximalIntersect, 1);
+void hpf_context_set_threads(HpfContext *ctx, int numThreads)
+/*************************************************************************
+hpf_context_set_threads - Solve the open intervals of the parametric cut
+with numThreads worker threads (default 1), or with one thread per online
+processor (0). With more than one thread the lower and upper bound
+problems are solved at the same time as well, unless free runs are on.
+Each worker holds its own copy of the solve caches. The breakpoints and
+cuts do not depend on the setting.
+*************************************************************************/
+{
+	long numProcessors;
 
+	if (numThreads <= 0)
+	{
+		numProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+		numThreads = numProcessors > 0 ? (int) numProcessors : 1;
 	}
+	ctx->numThreads = (uint) numThreads;
 }
 
-void reset_globals()
+void hpf_context_set_parallel_pseudoflow(HpfContext *ctx, int minNodes)
+/*************************************************************************
+hpf_context_set_parallel_pseudoflow - Solve subproblems with at least
+minNodes nodes with a parallel pseudoflow run: the strong roots of the
+highest label are scanned in batches by all threads the context has for
+the problem, and merged in the order of the batch. These are the threads
+of hpf_context_set_threads for the bound problems, and the threads that no
+other worker runs on for a problem solved by a worker. 0 disables the
+parallel run (default). The cuts do not depend on the setting, the work
+does.
+*************************************************************************/
 {
-	TOL = 1E-7;
-	numNodes = 0;
-	numArcs = 0;
-	numNodesSuper = 0;
-	numArcsSuper = 0;
-	source = 0;
-	sink = 0;
-	highestStrongLabel = 1;
-
-	numArcScans = 0;
-	numPushes = 0;
-	numMergers = 0;
-	numRelabels = 0;
-	numGaps = 0;
-
-	nodesList = NULL;
-	strongRoots = NULL;
-	labelCount = NULL;
-	arcList = NULL;
-	nodeListSuper = NULL;
-	arcListSuper = NULL;
-	lowestPositiveExcessNode = 0;
-
-	lastBreakpoint = NULL;
-	firstBreakpoint = NULL;
-
-	useParametricCut = 1;
-	roundNegativeCapacity = 0;
+	ctx->parallelPseudoflowNodes = minNodes > 0 ? (uint) minNodes : 0;
+}
 
-	LAMBDA_LOW = 0;
-	LAMBDA_HIGH = 0;
+void hpf_context_set_regions(HpfContext *ctx, int minNodes)
+/*************************************************************************
+hpf_context_set_regions - Split problems with at least minNodes nodes
+that are solved from zero flow into one block of consecutive nodes per
+thread the context has for them, solve the blocks in parallel without the
+arcs between them, and start the solve of the problem from their flows.
+For grids numbered in raster order the blocks are slabs of the grid. 0
+disables the blocks (default). The cuts do not depend on the setting, the
+work does: the blocks scan about as many arcs as the solve from zero flow
+and the solve from their flows about 40% more, so they only pay off with
+at least three threads on separate processors.
+*************************************************************************/
+{
+	ctx->regionNodes = minNodes > 0 ? (uint) minNodes : 0;
+}
 
-    freeCaches();
+void hpf_context_set_undirected(HpfContext *ctx, int undirected)
+/*************************************************************************
+hpf_context_set_undirected - Read the arcs between nodes other than the
+source and sink as undirected edges: an arc (u, v) with constant capacity
+c lets up to c units flow from u to v or from v to u, and takes the place
+of the arcs (u, v) and (v, u). Each edge is stored and scanned once. The
+arcs of the source and sink stay directed. 0 reads all arcs as directed
+(default).
+*************************************************************************/
+{
+	ctx->undirected = undirected != 0;
 }
 
-int cmpArc(const void *a, const void *b){
+static int cmpArc(const void *a, const void *b){
     uint mgcNum = 10;
-    uint a_from = (((Arc *)a)->from->number) >> mgcNum ;
-    uint a_to = (((Arc *)a)->to->number) >> mgcNum ;
-    uint b_from = (((Arc *)b)->from->number) >> mgcNum ;
-    uint b_to = (((Arc *)b)->to->number) >> mgcNum ;
+    uint a_from = (((Arc *)a)->from) >> mgcNum ;
+    uint a_to = (((Arc *)a)->to) >> mgcNum ;
+    uint b_from = (((Arc *)b)->from) >> mgcNum ;
+    uint b_to = (((Arc *)b)->to) >> mgcNum ;
     if(a_from > b_from) return 1;
     if(b_from > a_from) return -1;
     if(a_to > b_to ) return 1;
@@ -2277,96 +6166,125 @@ int cmpArc(const void *a, const void *b){
     return 0;
 }
 
-void hpf_solve(int numNodesIn, int numArcsIn, int sourceIn, int sinkIn, double * arcMatrix,
-	double lambdaRange[2], int roundNegativeCapacityIn, int * numBreakpoints, double ** cuts,
-	double ** breakpoints, int stats[5], double times[3] )
+static int unwoundSolve(HpfContext *ctx)
 /*************************************************************************
-main - Main function
+unwoundSolve - Free what a read or solve unwound by arenaRaise still
+holds and return its error
 *************************************************************************/
 {
-	reset_globals();
+	freeMemoryComplete(ctx);
+	freeTracked(ctx);
+	ctx->arena.unwind = NULL;
+	return ctx->arena.error;
+}
 
-	double readStart, readEnd, initStart, initEnd, solveStart, solveEnd;
+static int solveGraphSuper(HpfContext *ctx, double readTime, int * numBreakpoints, double ** cuts,
+	double ** breakpoints, int stats[5], double times[3])
+/*************************************************************************
+solveGraphSuper - Solve the parametric cut problem on the super graph
+read into ctx, write the output and free the graph. A solve that exceeds
+the arena limit or runs out of memory is unwound to here, frees what it
+holds and returns the error without output.
+*************************************************************************/
+{
+	double initStart, initEnd, solveStart, solveEnd;
+	jmp_buf unwind;
 
-	numArcScans = 0;
-	numMergers = 0;
-	numPushes = 0;
-	numRelabels = 0;
-	numGaps = 0;
+	*numBreakpoints = 0;
+	*cuts = NULL;
+	*breakpoints = NULL;
 
-	// printf("NumNodes: %d\n", numNodesIn);
-	// printf("NumArcs: %d\n", numArcsIn);
-	// printf("Lambda Range: [%lf, %lf]\n", lambdaRange[0], lambdaRange[1]);
-	// printf("Round if negative: %d\n", roundNegativeCapacity);
-	// printf("Arc matrix:\n");
-	// for (int i = 0; i < numArcsIn; ++i)
-	// {
-	// 	printf("Row %d: [%.2lf, %.2lf, %.2lf, %.2lf]\n", i, arcMatrix[i * 4 + 0 ], arcMatrix[i * 4 + 1 ], arcMatrix[i * 4 + 2 ], arcMatrix[i * 4 + 3 ]);
-	// }
+	ctx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
+	{
+		return unwoundSolve(ctx);
+	}
 
-	readStart = clock();
-	// readInput
-	numNodesSuper = numNodesIn;
-	numArcsSuper = numArcsIn;
-	sourceSuper = (uint) sourceIn;
-	sinkSuper = (uint) sinkIn;
-	LAMBDA_LOW = lambdaRange[0];
-	LAMBDA_HIGH = lambdaRange[1];
-	if (LAMBDA_LOW == LAMBDA_HIGH)
-		useParametricCut = 0;
-	roundNegativeCapacity = roundNegativeCapacityIn;
-	readGraphSuper( arcMatrix );
-	readEnd = clock();
+	/* size the arena for the scratch memory of a full size solve and its residual
+	search. Source sets and warm start bits are allocated outside the arena. */
+	arenaReserve(&ctx->arena,
+		(size_t) ctx->numNodesSuper * (sizeof(Root) + 6 * sizeof(uint) + 2 * sizeof(char))
+		+ (size_t) ctx->numArcsSuper * (4 * sizeof(uint)));
 
     //printf("c sorting arcs and initializing par cut\n");
-	initStart = clock();
-    qsort(arcListSuper, numArcsSuper, sizeof(Arc), cmpArc);
-	CutProblem lowProblem;
-	CutProblem highProblem;
-	initializeParametricCut(&lowProblem,&highProblem);
-	initEnd = clock();
+	initStart = wallClock();
+    qsort(ctx->arcListSuper, ctx->numArcsSuper, sizeof(Arc), cmpArc);
+    if (ctx->useParametricCut == 1)
+    {
+        buildSuperIncidence(ctx);
+    }
+	CutProblem *lowProblem = NULL;
+	CutProblem *highProblem = NULL;
+	if (!useSeedPoints(ctx))
+	{
+		lowProblem = createProblem(ctx);
+		highProblem = createProblem(ctx);
+		initializeParametricCut(ctx, lowProblem, highProblem);
+	}
+	initEnd = wallClock();
 
-	solveStart = clock();
-	if (useParametricCut == 1)
+	solveStart = wallClock();
+	if (useSeedPoints(ctx))
 	{
-        // solve lower bound problem
-        solveProblem(&lowProblem, 0);
-        destroyProblem(&lowProblem, 0);
+        // solve the lower and upper bound problems and the seeds, then the intervals between them
+        seededParametricCut(ctx, &lowProblem, &highProblem);
+
+        // add upper bound as final breakpoint for last interval.
+        addBreakpoint(ctx, NULL, lambdaToDouble(highProblem->lambdaValue), highProblem);
+	}
+	else if (ctx->useParametricCut == 1)
+	{
+        // the flows of the upper bound problem warm start the problems below it
+        if (ctx->warmStart)
+            highProblem->saturatedArcs = allocateArcBits(ctx);
+
+        // solve lower bound problem, with free runs the upper bound problem continues its run
+        solveProblem(ctx, lowProblem, NULL, useFreeRuns(ctx) ? highProblem : NULL);
+        destroyProblem(ctx, lowProblem);
 
         // solve upper bound problem
-        solveProblem(&highProblem, 0);
-        destroyProblem(&highProblem, 0); // Change on 5/2/2024
+        if (!highProblem->solved)
+            solveProblem(ctx, highProblem, NULL, NULL);
+        destroyProblem(ctx, highProblem); // Change on 5/2/2024
 
-        // find breakpoints + recurse
-		    parametricCut(&lowProblem, &highProblem);
+        evaluateCutFunction(ctx, lowProblem);
+        evaluateCutFunction(ctx, highProblem);
 
-        // add upper bound as final breakpoint for last interval.
-        addBreakpoint(highProblem.lambdaValue, highProblem.optimalSourceSetIndicator);
+        // find breakpoints of all intervals
+		    parametricCut(ctx, lowProblem, highProblem);
 
-		/* deallocate memory */
-		destroyProblem(&lowProblem, 1);
-		destroyProblem(&highProblem, 1);
+        // add upper bound as final breakpoint for last interval.
+        addBreakpoint(ctx, NULL, lambdaToDouble(highProblem->lambdaValue), highProblem);
 	}
 	else
 	{
-		printf("Solving problem with lambda value %.15lf\n", lowProblem.lambdaValue);
-		solveProblem(&lowProblem,0);
+		printf("Solving problem with lambda value %.15lf\n", lambdaToDouble(lowProblem->lambdaValue));
+		solveProblem(ctx, lowProblem, NULL, NULL);
+		destroyProblem(ctx, lowProblem);
 		/* add solution as breakpoint */
-		addBreakpoint(lowProblem.lambdaValue, lowProblem.optimalSourceSetIndicator);
-		/* deallocate memory */
-		destroyProblem(&lowProblem, 1);
+		addBreakpoint(ctx, NULL, lambdaToDouble(lowProblem->lambdaValue), lowProblem);
+	}
+
+	/* deallocate memory */
+	releaseProblem(ctx, lowProblem);
+	releaseProblem(ctx, highProblem);
+	solveEnd = wallClock();
+
+	/* a capacity that overflowed in an integer capacity mode (see scaledCapacity) */
+	if (ctx->error != HPF_OK)
+	{
+		arenaRaise(&ctx->arena, ctx->error);
 	}
-	solveEnd = clock();
 
-	times[0] = (readEnd - readStart)/CLOCKS_PER_SEC;
-	times[1] = (initEnd - initStart)/CLOCKS_PER_SEC;
-	times[2] = (solveEnd - solveStart)/CLOCKS_PER_SEC;
+	times[0] = readTime;
+	times[1] = initEnd - initStart;
+	times[2] = solveEnd - solveStart;
 
 	/* RECOVER FLOW NEEDS TO BE ADAPTED TO DEAL WITH PARAMETRIC ALGORITHM */
 	//	recoverFlow( numNodes );
 	//	flow = checkOptimality (numNodes);
 
-	prepareOutput(numBreakpoints, cuts, breakpoints, stats);
+	prepareOutput(ctx, numBreakpoints, cuts, breakpoints, stats);
 
 	printf("Stats: [%d, %d, %d, %d, %d]\n", stats[0],stats[1],stats[2],stats[3],stats[4]);
 	printf("times: [%lf, %lf, %lf]\n", times[0],times[1],times[2]);
@@ -2382,7 +6300,324 @@ main - Main function
 	// }
 
 
-	freeMemoryComplete ();
+	freeMemoryComplete (ctx);
+	ctx->arena.unwind = NULL;
+	return HPF_OK;
+}
+
+int hpf_solve_context(HpfContext *ctx, int numNodesIn, int numArcsIn, int sourceIn, int sinkIn,
+	double * arcMatrix, double lambdaRange[2], int roundNegativeCapacityIn, int * numBreakpoints,
+	double ** cuts, double ** breakpoints, int stats[5], double times[3] )
+/*************************************************************************
+hpf_solve_context - Solve the parametric cut problem with the solver state
+held in ctx. Contexts are independent, so distinct contexts can be used
+from different threads at the same time. Returns HPF_OK, or
+HPF_ERROR_ARENA_LIMIT or HPF_ERROR_OUT_OF_MEMORY without output. The
+integer capacity modes return HPF_ERROR_INVALID_INPUT without output for
+a fractional capacity, or one that overflows at a lambda value of the
+solve.
+*************************************************************************/
+{
+	resetContext(ctx);
+
+	double readStart, readEnd;
+	jmp_buf unwind;
+
+	ctx->numArcScans = 0;
+	ctx->numMergers = 0;
+	ctx->numPushes = 0;
+	ctx->numRelabels = 0;
+	ctx->numGaps = 0;
+
+	// printf("NumNodes: %d\n", numNodesIn);
+	// printf("NumArcs: %d\n", numArcsIn);
+	// printf("Lambda Range: [%lf, %lf]\n", lambdaRange[0], lambdaRange[1]);
+	// printf("Round if negative: %d\n", roundNegativeCapacity);
+	// printf("Arc matrix:\n");
+	// for (int i = 0; i < numArcsIn; ++i)
+	// {
+	// 	printf("Row %d: [%.2lf, %.2lf, %.2lf, %.2lf]\n", i, arcMatrix[i * 4 + 0 ], arcMatrix[i * 4 + 1 ], arcMatrix[i * 4 + 2 ], arcMatrix[i * 4 + 3 ]);
+	// }
+
+	readStart = wallClock();
+	// readInput
+	ctx->numNodesSuper = numNodesIn;
+	ctx->numArcsSuper = numArcsIn;
+	ctx->sourceSuper = (uint) sourceIn;
+	ctx->sinkSuper = (uint) sinkIn;
+	ctx->LAMBDA_LOW = lambdaFromDouble(lambdaRange[0]);
+	ctx->LAMBDA_HIGH = lambdaFromDouble(lambdaRange[1]);
+	if (lambdaRange[0] == lambdaRange[1])
+		ctx->useParametricCut = 0;
+	ctx->roundNegativeCapacity = roundNegativeCapacityIn;
+	*numBreakpoints = 0;
+	*cuts = NULL;
+	*breakpoints = NULL;
+	ctx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
+	{
+		return unwoundSolve(ctx);
+	}
+	readGraphSuper(ctx, arcMatrix );
+	readEnd = wallClock();
+
+	return solveGraphSuper(ctx, readEnd - readStart, numBreakpoints, cuts, breakpoints, stats, times);
+}
+
+int hpf_solve(int numNodesIn, int numArcsIn, int sourceIn, int sinkIn, double * arcMatrix,
+	double lambdaRange[2], int roundNegativeCapacityIn, int * numBreakpoints, double ** cuts,
+	double ** breakpoints, int stats[5], double times[3] )
+/*************************************************************************
+hpf_solve - Solve with a temporary context
+*************************************************************************/
+{
+	HpfContext *ctx = hpf_context_create();
+	int error;
+
+	if (ctx == NULL)
+	{
+		*numBreakpoints = 0;
+		*cuts = NULL;
+		*breakpoints = NULL;
+		return HPF_ERROR_OUT_OF_MEMORY;
+	}
+
+	error = hpf_solve_context(ctx, numNodesIn, numArcsIn, sourceIn, sinkIn, arcMatrix, lambdaRange,
+		roundNegativeCapacityIn, numBreakpoints, cuts, breakpoints, stats, times);
+
+	hpf_context_destroy(ctx);
+	return error;
+}
+
+static int checkConductanceGraph(int numNodesIn, int numEdgesIn, const double *edgeMatrix,
+	const double *nodeWeights, const double *sinkWeights, int numSeedNodes, const int *seedNodes)
+/*************************************************************************
+checkConductanceGraph - Validate a conductance problem before anything is
+allocated for it: every seed and edge end is a node of the graph and no
+weight is negative. Returns HPF_OK or HPF_ERROR_INVALID_INPUT.
+*************************************************************************/
+{
+	int i;
+
+	for (i = 0; i < numSeedNodes; ++i)
+	{
+		if (seedNodes[i] < 0 || seedNodes[i] >= numNodesIn)
+		{
+			printf("Seed node %d is not a node of the graph.\n", seedNodes[i]);
+			return HPF_ERROR_INVALID_INPUT;
+		}
+	}
+	for (i = 0; i < numEdgesIn; ++i)
+	{
+		if (edgeMatrix[i * 3 + 0] < 0 || edgeMatrix[i * 3 + 0] >= numNodesIn ||
+			edgeMatrix[i * 3 + 1] < 0 || edgeMatrix[i * 3 + 1] >= numNodesIn)
+		{
+			printf("Edge %d joins a node that is not in the graph.\n", i);
+			return HPF_ERROR_INVALID_INPUT;
+		}
+		if (edgeMatrix[i * 3 + 2] < 0)
+		{
+			printf("Edge %d has a negative weight.\n", i);
+			return HPF_ERROR_INVALID_INPUT;
+		}
+	}
+	for (i = 0; i < numNodesIn; ++i)
+	{
+		if ((nodeWeights != NULL && nodeWeights[i] < 0) || (sinkWeights != NULL && sinkWeights[i] < 0))
+		{
+			printf("Node %d has a negative weight.\n", i);
+			return HPF_ERROR_INVALID_INPUT;
+		}
+	}
+	return HPF_OK;
+}
+
+static void readConductanceGraph(HpfContext *ctx, int numNodesIn, int numEdgesIn, const double *edgeMatrix,
+	const double *nodeWeights, const double *sinkWeights, int numSeedNodes, const int *seedNodes)
+/*************************************************************************
+readConductanceGraph - Super graph of a conductance problem: node i of
+the input is super node i + 1 between the source 0 and the sink
+numNodesIn + 1. An edge becomes an undirected edge of the super graph
+with its weight as constant (see hpf_context_set_undirected). A node gets a source arc with its weight as multiplier and a
+sink arc with its sink weight as constant. Seed nodes are merged into the
+source: their edges become source arcs with a constant capacity, they keep
+no terminal arcs of their own. The input is checked by
+checkConductanceGraph.
+*************************************************************************/
+{
+	uint i, u, v;
+	uint numArcs = 0;
+	uint sink = (uint) numNodesIn + 1;
+	double weight;
+	double *degree;
+	char *seed;
+
+	degree = (double *)trackedMalloc(ctx, (numNodesIn + 2) * sizeof(double));
+	seed = (char *)trackedMalloc(ctx, (numNodesIn + 2) * sizeof(char));
+	memset(degree, 0, (numNodesIn + 2) * sizeof(double));
+	memset(seed, 0, (numNodesIn + 2) * sizeof(char));
+
+	for (i = 0; i < (uint) numSeedNodes; ++i)
+	{
+		seed[seedNodes[i] + 1] = 1;
+	}
+
+	/* count the arcs, and the weighted degrees for the missing node weights */
+	for (i = 0; i < (uint) numEdgesIn; ++i)
+	{
+		u = (uint) edgeMatrix[i * 3 + 0] + 1;
+		v = (uint) edgeMatrix[i * 3 + 1] + 1;
+		weight = edgeMatrix[i * 3 + 2];
+		degree[u] += weight;
+		degree[v] += weight;
+		if (u != v && !(seed[u] && seed[v]))
+		{
+			++numArcs;
+		}
+	}
+	for (i = 1; i <= (uint) numNodesIn; ++i)
+	{
+		if (!seed[i])
+		{
+			numArcs += (nodeWeights == NULL ? degree[i] : nodeWeights[i - 1]) != 0;
+			numArcs += sinkWeights != NULL && sinkWeights[i - 1] != 0;
+		}
+	}
+
+	ctx->numNodesSuper = (uint) numNodesIn + 2;
+	ctx->numArcsSuper = numArcs;
+	allocateGraphSuper(ctx);
+
+	numArcs = 0;
+	for (i = 0; i < (uint) numEdgesIn; ++i)
+	{
+		u = (uint) edgeMatrix[i * 3 + 0] + 1;
+		v = (uint) edgeMatrix[i * 3 + 1] + 1;
+		weight = edgeMatrix[i * 3 + 2];
+		if (u == v || (seed[u] && seed[v]))
+		{
+			continue;
+		}
+		if (seed[u])
+		{
+			setArcSuper(ctx, numArcs++, 0, v, weight, 0);
+		}
+		else
+		{
+			setArcSuper(ctx, numArcs++, seed[v] ? 0 : u, seed[v] ? u : v, weight, 0);
+		}
+	}
+	for (i = 1; i <= (uint) numNodesIn; ++i)
+	{
+		weight = nodeWeights == NULL ? degree[i] : nodeWeights[i - 1];
+		if (seed[i])
+		{
+			continue;
+		}
+		if (weight != 0)
+		{
+			setArcSuper(ctx, numArcs++, 0, i, 0, weight);
+		}
+		if (sinkWeights != NULL && sinkWeights[i - 1] != 0)
+		{
+			setArcSuper(ctx, numArcs++, i, sink, sinkWeights[i - 1], 0);
+		}
+	}
+
+	trackedFree(ctx, degree, (numNodesIn + 2) * sizeof(double));
+	trackedFree(ctx, seed, (numNodesIn + 2) * sizeof(char));
+}
+
+int hpf_conductance(HpfContext *ctx, int numNodesIn, int numEdgesIn, double * edgeMatrix,
+	double * nodeWeights, double * sinkWeights, int numSeedNodes, int * seedNodes, double lambdaRange[2],
+	int * numBreakpoints, double ** nodeLambdas, double ** breakpoints, int stats[5], double times[3] )
+/*************************************************************************
+hpf_conductance - Solve the parametric cut problem of a conductance
+(ratio) problem on an undirected graph without building its terminal
+arcs: for every lambda in lambdaRange, the source set S minimizes
+	C(S, V - S) + sinkWeight(S) - lambda * nodeWeight(S)
+with the seed nodes in S. edgeMatrix holds numEdgesIn rows (u, v,
+weight) over the nodes 0 .. numNodesIn - 1. nodeWeights defaults to the
+weighted degrees (the volume of S), sinkWeights to none. nodeLambdas
+holds for each node the upper bound of the first lambda interval with the
+node in S, the lower bound of the range for the seed nodes. Returns like
+hpf_solve_context, or HPF_ERROR_INVALID_INPUT for a seed or an edge
+outside of the graph, a negative weight or a negative lambda range.
+*************************************************************************/
+{
+	double readStart, readEnd;
+	double *cuts;
+	uint undirected = ctx->undirected;
+	int i, error;
+	jmp_buf unwind;
+
+	resetContext(ctx);
+
+	ctx->numArcScans = 0;
+	ctx->numMergers = 0;
+	ctx->numPushes = 0;
+	ctx->numRelabels = 0;
+	ctx->numGaps = 0;
+
+	*numBreakpoints = 0;
+	*nodeLambdas = NULL;
+	*breakpoints = NULL;
+	if (lambdaRange[0] < 0)
+	{
+		printf("The lambda range of a conductance problem starts at 0 or above.\n");
+		return HPF_ERROR_INVALID_INPUT;
+	}
+	if ((error = checkConductanceGraph(numNodesIn, numEdgesIn, edgeMatrix, nodeWeights, sinkWeights,
+		numSeedNodes, seedNodes)) != HPF_OK)
+	{
+		return error;
+	}
+
+	readStart = wallClock();
+	ctx->sourceSuper = 0;
+	ctx->sinkSuper = (uint) numNodesIn + 1;
+	ctx->LAMBDA_LOW = lambdaFromDouble(lambdaRange[0]);
+	ctx->LAMBDA_HIGH = lambdaFromDouble(lambdaRange[1]);
+	if (lambdaRange[0] == lambdaRange[1])
+		ctx->useParametricCut = 0;
+	/* no capacity is negative for lambda >= 0, there is nothing to round */
+	ctx->roundNegativeCapacity = 0;
+	/* the edges are stored once whatever the setting of the context */
+	ctx->undirected = 1;
+	ctx->arena.unwind = &unwind;
+	if (setjmp(unwind) != 0)
+	{
+		ctx->undirected = undirected;
+		return unwoundSolve(ctx);
+	}
+	readConductanceGraph(ctx, numNodesIn, numEdgesIn, edgeMatrix, nodeWeights, sinkWeights,
+		numSeedNodes, seedNodes);
+	readEnd = wallClock();
 
+	error = solveGraphSuper(ctx, readEnd - readStart, numBreakpoints, &cuts, breakpoints, stats, times);
+	ctx->undirected = undirected;
+	if (error != HPF_OK)
+	{
+		*nodeLambdas = NULL;
+		return error;
+	}
 
+	if ((*nodeLambdas = (double *)malloc((numNodesIn > 0 ? numNodesIn : 1) * sizeof(double))) == NULL)
+	{
+		free(cuts);
+		free(*breakpoints);
+		*breakpoints = NULL;
+		*numBreakpoints = 0;
+		return HPF_ERROR_OUT_OF_MEMORY;
+	}
+	for (i = 0; i < numNodesIn; ++i)
+	{
+		(*nodeLambdas)[i] = cuts[i + 1];
+	}
+	for (i = 0; i < numSeedNodes; ++i)
+	{
+		(*nodeLambdas)[seedNodes[i]] = lambdaRange[0];
+	}
+	free(cuts);
+	return HPF_OK;
 }
@@ -1,4 +1,74 @@
-void hpf_solve(int numNodes, int numArcs, int source, int sink, double * arcMatrix, double lambdaRange[2],
-  int roundNegativeCapacityIn, int * numBreakpoints, double ** cuts, double ** breakpoints, int stats[5], double times[3] );
+#ifndef LIBHPF_H
+#define LIBHPF_H
+
+#include <stddef.h>
+
+/* The solver is compiled once per capacity type. Every instantiation exports
+the same API with its own suffix and context type:
+	(none)  - double capacities (hpf_solve, HpfContext, ...)
+	_float  - float capacities (hpf_solve_float, HpfContext_float, ...)
+	_int32  - exact int32 capacities (hpf_solve_int32, HpfContext_int32, ...)
+	_int64  - exact int64 capacities (hpf_solve_int64, HpfContext_int64, ...)
+Input and output are double for all instantiations. The integer
+instantiations require integer constants and multipliers. */
+
+/* Return codes of hpf_solve, hpf_solve_context and hpf_conductance. The
+outputs are only allocated by a solve that returns HPF_OK. */
+#define HPF_OK 0
+#define HPF_ERROR_ARENA_LIMIT 1
+#define HPF_ERROR_OUT_OF_MEMORY 2
+#define HPF_ERROR_INVALID_INPUT 3
+
+#define HPF_DECLARE_API(suffix) \
+	typedef struct HpfContext##suffix HpfContext##suffix; \
+	\
+	HpfContext##suffix * hpf_context_create##suffix(void); \
+	\
+	void hpf_context_destroy##suffix(HpfContext##suffix *ctx); \
+	\
+	size_t hpf_context_arena_high_water##suffix(const HpfContext##suffix *ctx); \
+	\
+	void hpf_context_set_arena_limit##suffix(HpfContext##suffix *ctx, size_t limit); \
+	\
+	void hpf_context_set_warm_start##suffix(HpfContext##suffix *ctx, int warmStart); \
+	\
+	void hpf_context_set_free_runs##suffix(HpfContext##suffix *ctx, int freeRuns); \
+	\
+	void hpf_context_set_breadth_first##suffix(HpfContext##suffix *ctx, int breadthFirst); \
+	\
+	void hpf_context_set_open_interval_cap##suffix(HpfContext##suffix *ctx, int cap); \
+	\
+	int hpf_context_max_queue_depth##suffix(const HpfContext##suffix *ctx); \
+	\
+	void hpf_context_set_threads##suffix(HpfContext##suffix *ctx, int numThreads); \
+	\
+	double hpf_context_endpoint_overlap##suffix(const HpfContext##suffix *ctx); \
+	\
+	void hpf_context_set_seeds##suffix(HpfContext##suffix *ctx, int numSeeds, int fromTerminalRatios); \
+	\
+	void hpf_context_set_parallel_pseudoflow##suffix(HpfContext##suffix *ctx, int minNodes); \
+	\
+	void hpf_context_set_regions##suffix(HpfContext##suffix *ctx, int minNodes); \
+	\
+	void hpf_context_set_undirected##suffix(HpfContext##suffix *ctx, int undirected); \
+	\
+	int hpf_solve_context##suffix(HpfContext##suffix *ctx, int numNodes, int numArcs, int source, int sink, \
+	  double * arcMatrix, double lambdaRange[2], int roundNegativeCapacityIn, int * numBreakpoints, \
+	  double ** cuts, double ** breakpoints, int stats[5], double times[3] ); \
+	\
+	int hpf_solve##suffix(int numNodes, int numArcs, int source, int sink, double * arcMatrix, \
+	  double lambdaRange[2], int roundNegativeCapacityIn, int * numBreakpoints, double ** cuts, \
+	  double ** breakpoints, int stats[5], double times[3] ); \
+	\
+	int hpf_conductance##suffix(HpfContext##suffix *ctx, int numNodes, int numEdges, double * edgeMatrix, \
+	  double * nodeWeights, double * sinkWeights, int numSeedNodes, int * seedNodes, double lambdaRange[2], \
+	  int * numBreakpoints, double ** nodeLambdas, double ** breakpoints, int stats[5], double times[3] );
+
+HPF_DECLARE_API()
+HPF_DECLARE_API(_float)
+HPF_DECLARE_API(_int32)
+HPF_DECLARE_API(_int64)
 
 void libfree(void * p);
+
+#endif
@@ -0,0 +1,6 @@
+/*************************************************************************
+float32 instantiation of the solver in libhpf.c. Exports the API of
+libhpf.h with the _float suffix.
+*************************************************************************/
+#define HPF_CAPACITY_FLOAT
+#include "libhpf.c"
@@ -0,0 +1,6 @@
+/*************************************************************************
+int32 instantiation of the solver in libhpf.c. Exports the API of
+libhpf.h with the _int32 suffix.
+*************************************************************************/
+#define HPF_CAPACITY_INT32
+#include "libhpf.c"
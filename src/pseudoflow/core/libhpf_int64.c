@@ -0,0 +1,6 @@
+/*************************************************************************
+int64 instantiation of the solver in libhpf.c. Exports the API of
+libhpf.h with the _int64 suffix.
+*************************************************************************/
+#define HPF_CAPACITY_INT64
+#include "libhpf.c"
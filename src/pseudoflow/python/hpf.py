@@ -1,4 +1,4 @@
-from ctypes import c_int, c_double, cast, byref, POINTER, cdll
+from ctypes import c_int, c_double, c_size_t, c_void_p, cast, byref, POINTER, cdll
 import os
 
 from pseudoflow.python.graph_wrapper import NetworkxGraphWrapper, IgraphGraphWrapper
@@ -71,7 +71,7 @@ def _create_c_input(
 
 def _create_c_output():
     c_numBreakpoints = c_int(0)
-    c_cuts = POINTER(c_int)()
+    c_cuts = POINTER(c_double)()
     c_breakpoints = POINTER(c_double)()
     c_stats = _c_arr(c_int, 5, (0,) * 5)
     c_times = _c_arr(c_double, 3, (0.0,) * 3)
@@ -82,12 +82,60 @@ def _create_c_output():
         "breakpoints": c_breakpoints,
         "stats": c_stats,
         "times": c_times,
+        "arenaHighWater": 0,
+        "maxQueueDepth": 0,
+        "endpointOverlap": 0.0,
     }
 
 
-def _solve(c_input, c_output):
-    hpf_solve = libhpf.hpf_solve
+_CAPACITY_TYPE_SUFFIX = {"double": "", "float": "_float", "int32": "_int32", "int64": "_int64"}
+
+# return codes of hpf_solve_context and hpf_conductance, see libhpf.h
+_HPF_ERRORS = {1: "Arena limit exceeded.", 2: "Out of memory.", 3: "Invalid input."}
+_HPF_ERROR_INVALID_INPUT = 3
+
+
+def _check_error(error):
+    if error == _HPF_ERROR_INVALID_INPUT:
+        raise ValueError(_HPF_ERRORS[error])
+    if error != 0:
+        raise MemoryError(_HPF_ERRORS.get(error, "Solver error %d." % error))
+
+
+def _solve(c_input, c_output, capacityType="double", numThreads=1, numSeeds=0,
+           seedsFromTerminalRatios=False, parallelPseudoflowNodes=0, regionNodes=0, undirected=False,
+           arenaLimit=0):
+    suffix = _CAPACITY_TYPE_SUFFIX[capacityType]
+    context_create = getattr(libhpf, "hpf_context_create" + suffix)
+    context_destroy = getattr(libhpf, "hpf_context_destroy" + suffix)
+    context_arena_high_water = getattr(libhpf, "hpf_context_arena_high_water" + suffix)
+
+    context_create.restype = c_void_p
+    context_destroy.argtypes = [c_void_p]
+    context_arena_high_water.argtypes = [c_void_p]
+    context_arena_high_water.restype = c_size_t
+    context_max_queue_depth = getattr(libhpf, "hpf_context_max_queue_depth" + suffix)
+    context_max_queue_depth.argtypes = [c_void_p]
+    context_max_queue_depth.restype = c_int
+    context_set_threads = getattr(libhpf, "hpf_context_set_threads" + suffix)
+    context_set_threads.argtypes = [c_void_p, c_int]
+    context_set_seeds = getattr(libhpf, "hpf_context_set_seeds" + suffix)
+    context_set_seeds.argtypes = [c_void_p, c_int, c_int]
+    context_set_parallel_pseudoflow = getattr(libhpf, "hpf_context_set_parallel_pseudoflow" + suffix)
+    context_set_parallel_pseudoflow.argtypes = [c_void_p, c_int]
+    context_set_regions = getattr(libhpf, "hpf_context_set_regions" + suffix)
+    context_set_regions.argtypes = [c_void_p, c_int]
+    context_set_undirected = getattr(libhpf, "hpf_context_set_undirected" + suffix)
+    context_set_undirected.argtypes = [c_void_p, c_int]
+    context_set_arena_limit = getattr(libhpf, "hpf_context_set_arena_limit" + suffix)
+    context_set_arena_limit.argtypes = [c_void_p, c_size_t]
+    context_endpoint_overlap = getattr(libhpf, "hpf_context_endpoint_overlap" + suffix)
+    context_endpoint_overlap.argtypes = [c_void_p]
+    context_endpoint_overlap.restype = c_double
+
+    hpf_solve = getattr(libhpf, "hpf_solve_context" + suffix)
     hpf_solve.argtypes = [
+        c_void_p,
         c_int,
         c_int,
         c_int,
@@ -96,13 +144,24 @@ def _solve(c_input, c_output):
         c_double * 2,
         c_int,
         POINTER(c_int),
-        POINTER(POINTER(c_int)),
+        POINTER(POINTER(c_double)),
         POINTER(POINTER(c_double)),
         c_int * 5,
         c_double * 3,
     ]
-
-    hpf_solve(
+    hpf_solve.restype = c_int
+
+    ctx = context_create()
+    if not ctx:
+        raise MemoryError(_HPF_ERRORS[2])
+    context_set_threads(ctx, numThreads)
+    context_set_arena_limit(ctx, arenaLimit)
+    context_set_seeds(ctx, numSeeds, int(seedsFromTerminalRatios))
+    context_set_parallel_pseudoflow(ctx, parallelPseudoflowNodes)
+    context_set_regions(ctx, regionNodes)
+    context_set_undirected(ctx, int(undirected))
+    error = hpf_solve(
+        ctx,
         c_input["numNodes"],
         c_input["numArcs"],
         c_input["source"],
@@ -116,6 +175,11 @@ def _solve(c_input, c_output):
         c_output["stats"],
         c_output["times"],
     )
+    c_output["arenaHighWater"] = context_arena_high_water(ctx)
+    c_output["maxQueueDepth"] = context_max_queue_depth(ctx)
+    c_output["endpointOverlap"] = context_endpoint_overlap(ctx)
+    context_destroy(ctx)
+    _check_error(error)
 
 
 def _cleanup(c_output):
@@ -141,15 +205,22 @@ def _check_multipliers_source_adjacent_positive(G, source, mult_cap):
             )
 
 
-def _read_output(c_output, nodeNames):
+def _read_output(c_output, nodeNames, source, sink):
     numBreakpoints = c_output["numBreakpoints"].value
     breakpoints = [c_output["breakpoints"][i] for i in range(numBreakpoints)]
 
+    # the solver returns for each node the first breakpoint with the node in
+    # the source set, and infinity for the nodes that never join it
     cuts = {}
     for i, node in enumerate(nodeNames):
-        cuts[node] = [
-            c_output["cuts"][len(nodeNames) * j + i] for j in range(numBreakpoints)
-        ]
+        if i == source:
+            cuts[node] = [1] * numBreakpoints
+        elif i == sink:
+            cuts[node] = [0] * numBreakpoints
+        else:
+            cuts[node] = [
+                int(c_output["cuts"][i] <= breakpoints[j]) for j in range(numBreakpoints)
+            ]
 
     info = {
         "numArcScans": c_output["stats"][0],
@@ -160,6 +231,9 @@ def _read_output(c_output, nodeNames):
         "readDataTime": c_output["times"][0],
         "intializationTime": c_output["times"][1],
         "solveTime": c_output["times"][2],
+        "arenaHighWater": c_output["arenaHighWater"],
+        "maxQueueDepth": c_output["maxQueueDepth"],
+        "endpointOverlap": c_output["endpointOverlap"],
     }
 
     return breakpoints, cuts, info
@@ -173,7 +247,20 @@ def hpf(
     mult_cap=None,
     lambdaRange=None,
     roundNegativeCapacity=False,
+    capacityType="double",
+    numThreads=1,
+    numSeeds=0,
+    seedsFromTerminalRatios=False,
+    parallelPseudoflowNodes=0,
+    regionNodes=0,
+    undirected=False,
+    arenaLimit=0,
 ):
+    if capacityType not in _CAPACITY_TYPE_SUFFIX:
+        raise ValueError(
+            "capacityType should be one of %s." % ", ".join(sorted(_CAPACITY_TYPE_SUFFIX))
+        )
+
     if "networkx" in G.__module__:
         G = NetworkxGraphWrapper(G)
     elif "igraph" in G.__module__:
@@ -200,9 +287,22 @@ def hpf(
     )
     c_output = _create_c_output()
 
-    _solve(c_input, c_output)
+    _solve(
+        c_input,
+        c_output,
+        capacityType,
+        numThreads,
+        numSeeds,
+        seedsFromTerminalRatios,
+        parallelPseudoflowNodes,
+        regionNodes,
+        undirected,
+        arenaLimit,
+    )
 
-    breakpoints, cuts, info = _read_output(c_output, nodeNames)
+    breakpoints, cuts, info = _read_output(
+        c_output, nodeNames, c_input["source"].value, c_input["sink"].value
+    )
 
     _cleanup(c_output)
 
@@ -210,3 +310,135 @@ def hpf(
         breakpoints = [None]
 
     return breakpoints, cuts, info
+
+
+def conductance(
+    G,
+    weight,
+    seeds=(),
+    node_weight=None,
+    sink_weight=None,
+    lambdaRange=None,
+    capacityType="double",
+    numThreads=1,
+    arenaLimit=0,
+):
+    """Parametric cuts of a conductance problem on the undirected graph G.
+
+    For every lambda the source set S holds the seeds and minimizes
+    cut(S) + sink_weight(S) - lambda * node_weight(S). node_weight defaults
+    to the weighted degree, sink_weight to none. The terminal arcs are built
+    by the solver. Returns the breakpoints, for each node the upper bound of
+    the first lambda interval with the node in S (infinity if it never joins
+    S), and the solver statistics.
+    Raises ValueError for a negative weight or lambda range, and MemoryError
+    when the solve exceeds arenaLimit bytes (0 for no limit) or runs out of
+    memory.
+    """
+    if capacityType not in _CAPACITY_TYPE_SUFFIX:
+        raise ValueError(
+            "capacityType should be one of %s." % ", ".join(sorted(_CAPACITY_TYPE_SUFFIX))
+        )
+
+    if "networkx" in G.__module__:
+        G = NetworkxGraphWrapper(G)
+    elif "igraph" in G.__module__:
+        G = IgraphGraphWrapper(G)
+    else:
+        raise TypeError(
+            "Graph should be networkx or igraph type. Please convert graph to one of those types."
+        )
+
+    nodeNames = list(G.nodes())
+    nodeDict = {node: i for i, node in enumerate(nodeNames)}
+    edgeMatrix = []
+    for fromNode, toNode, data in G.edges(data=True):
+        edgeMatrix += [nodeDict[fromNode], nodeDict[toNode], float(data[weight])]
+    seedNodes = [nodeDict[node] for node in seeds]
+    if lambdaRange is None:
+        lambdaRange = [0.0, 1.0]
+
+    nNodes = len(nodeNames)
+    nEdges = len(edgeMatrix) // 3
+    c_edgeMatrix = _c_arr(c_double, max(len(edgeMatrix), 1), edgeMatrix)
+    c_nodeWeights = None
+    if node_weight is not None:
+        c_nodeWeights = _c_arr(c_double, nNodes, [float(node_weight[node]) for node in nodeNames])
+    c_sinkWeights = None
+    if sink_weight is not None:
+        c_sinkWeights = _c_arr(c_double, nNodes, [float(sink_weight[node]) for node in nodeNames])
+    c_seedNodes = _c_arr(c_int, max(len(seedNodes), 1), seedNodes)
+    c_lambdaRange = _c_arr(c_double, 2, lambdaRange)
+    c_output = _create_c_output()
+    c_nodeLambdas = POINTER(c_double)()
+
+    suffix = _CAPACITY_TYPE_SUFFIX[capacityType]
+    context_create = getattr(libhpf, "hpf_context_create" + suffix)
+    context_create.restype = c_void_p
+    context_destroy = getattr(libhpf, "hpf_context_destroy" + suffix)
+    context_destroy.argtypes = [c_void_p]
+    context_set_threads = getattr(libhpf, "hpf_context_set_threads" + suffix)
+    context_set_threads.argtypes = [c_void_p, c_int]
+    hpf_conductance = getattr(libhpf, "hpf_conductance" + suffix)
+    hpf_conductance.argtypes = [
+        c_void_p,
+        c_int,
+        c_int,
+        POINTER(c_double),
+        POINTER(c_double),
+        POINTER(c_double),
+        c_int,
+        POINTER(c_int),
+        c_double * 2,
+        POINTER(c_int),
+        POINTER(POINTER(c_double)),
+        POINTER(POINTER(c_double)),
+        c_int * 5,
+        c_double * 3,
+    ]
+    hpf_conductance.restype = c_int
+    context_set_arena_limit = getattr(libhpf, "hpf_context_set_arena_limit" + suffix)
+    context_set_arena_limit.argtypes = [c_void_p, c_size_t]
+
+    ctx = context_create()
+    if not ctx:
+        raise MemoryError(_HPF_ERRORS[2])
+    context_set_threads(ctx, numThreads)
+    context_set_arena_limit(ctx, arenaLimit)
+    error = hpf_conductance(
+        ctx,
+        c_int(nNodes),
+        c_int(nEdges),
+        cast(c_edgeMatrix, POINTER(c_double)),
+        cast(c_nodeWeights, POINTER(c_double)) if c_nodeWeights is not None else None,
+        cast(c_sinkWeights, POINTER(c_double)) if c_sinkWeights is not None else None,
+        c_int(len(seedNodes)),
+        cast(c_seedNodes, POINTER(c_int)),
+        c_lambdaRange,
+        byref(c_output["numBreakpoints"]),
+        byref(c_nodeLambdas),
+        byref(c_output["breakpoints"]),
+        c_output["stats"],
+        c_output["times"],
+    )
+    context_destroy(ctx)
+    _check_error(error)
+
+    numBreakpoints = c_output["numBreakpoints"].value
+    breakpoints = [c_output["breakpoints"][i] for i in range(numBreakpoints)]
+    nodeLambdas = {node: c_nodeLambdas[i] for i, node in enumerate(nodeNames)}
+    info = {
+        "numArcScans": c_output["stats"][0],
+        "numMergers": c_output["stats"][1],
+        "numPushes": c_output["stats"][2],
+        "numRelabels": c_output["stats"][3],
+        "numGap": c_output["stats"][4],
+        "readDataTime": c_output["times"][0],
+        "intializationTime": c_output["times"][1],
+        "solveTime": c_output["times"][2],
+    }
+
+    libhpf.libfree(c_output["breakpoints"])
+    libhpf.libfree(c_nodeLambdas)
+
+    return breakpoints, nodeLambdas, info
@@ -1,7 +1,9 @@
+import random
+
 import igraph
 import networkx as nx
 import pytest
-from pseudoflow import hpf
+from pseudoflow import hpf, conductance
 
 
 @pytest.fixture()
@@ -576,3 +578,172 @@ def test_for_igraph_support():
 
     assert breakpoints == [1.0, 2.0]
     assert cuts == {0: [1, 1], 1: [0, 1], 2: [0, 0]}
+
+
+def _random_parametric_graph(seed, numNodes=30, numArcs=90):
+    # integer capacities, so that every capacity type solves the same problem
+    rng = random.Random(seed)
+    G = nx.DiGraph()
+    for node in range(numNodes):
+        constant = rng.randint(0, 20)
+        G.add_edge("s", node, const=-constant, mult=rng.randint(1, 20))
+        G.add_edge(node, "t", const=constant, mult=-rng.randint(1, 20))
+    while G.number_of_edges() < 2 * numNodes + numArcs:
+        from_node = rng.randrange(numNodes)
+        to_node = rng.randrange(numNodes)
+        if from_node != to_node:
+            G.add_edge(from_node, to_node, const=rng.randint(1, 10), mult=0)
+    return G
+
+
+def _random_undirected_graph(seed, numNodes=30, numEdges=45):
+    rng = random.Random(seed)
+    G = nx.Graph()
+    G.add_nodes_from(range(numNodes))
+    while G.number_of_edges() < numEdges:
+        u = rng.randrange(numNodes)
+        v = rng.randrange(numNodes)
+        if u != v:
+            G.add_edge(u, v, weight=rng.randint(1, 10))
+    return G
+
+
+def _parametric_cut(G, **kwargs):
+    return hpf(
+        G,
+        "s",
+        "t",
+        const_cap="const",
+        mult_cap="mult",
+        lambdaRange=[0.0, 2.0],
+        roundNegativeCapacity=True,
+        **kwargs
+    )
+
+
+@pytest.mark.parametrize(
+    "kwargs",
+    [
+        {"capacityType": "float"},
+        {"capacityType": "int32"},
+        {"capacityType": "int64"},
+        {"numThreads": 4},
+        {"numSeeds": 3},
+        {"numSeeds": 3, "seedsFromTerminalRatios": True},
+        {"numThreads": 4, "numSeeds": 6},
+        {"numThreads": 4, "parallelPseudoflowNodes": 1},
+        {"numThreads": 4, "regionNodes": 1},
+    ],
+)
+def test_hpf_options_match_default(kwargs):
+    G = _random_parametric_graph(11)
+    expected_breakpoints, expected_cuts, _ = _parametric_cut(G)
+
+    breakpoints, cuts, _ = _parametric_cut(G, **kwargs)
+
+    assert breakpoints == pytest.approx(expected_breakpoints, abs=1e-5)
+    assert cuts == expected_cuts
+
+
+def test_hpf_undirected_matches_both_directions():
+    G = _random_parametric_graph(12)
+    H = nx.DiGraph()
+    for from_node, to_node, data in G.edges(data=True):
+        H.add_edge(from_node, to_node, **data)
+        if "s" not in {from_node, to_node} and "t" not in {from_node, to_node}:
+            H.add_edge(to_node, from_node, **data)
+    expected_breakpoints, expected_cuts, _ = _parametric_cut(H)
+
+    breakpoints, cuts, _ = _parametric_cut(G, undirected=True)
+
+    assert breakpoints == pytest.approx(expected_breakpoints)
+    assert cuts == expected_cuts
+
+
+def test_hpf_arena_limit_raises_memoryerror():
+    G = _random_parametric_graph(13)
+
+    with pytest.raises(MemoryError):
+        _parametric_cut(G, arenaLimit=1)
+
+
+def test_hpf_fractional_integer_capacity_raises_valueerror():
+    G = _random_parametric_graph(14)
+    u, v = next(iter(G.edges()))
+    G[u][v]["const"] += 0.5
+
+    with pytest.raises(ValueError):
+        _parametric_cut(G, capacityType="int64")
+
+
+def test_hpf_integer_capacity_overflow_raises_valueerror():
+    # 6e8 * lambda leaves the int32 capacity range before lambda = 2
+    G = nx.DiGraph()
+    G.add_edge("s", "a", const=0, mult=6e8)
+    G.add_edge("a", "t", const=1e9, mult=0)
+
+    with pytest.raises(ValueError):
+        _parametric_cut(G, capacityType="int32")
+
+
+def _conductance_as_parametric_cut(G, sink_weight, seeds=()):
+    # the network hpf_conductance builds: seeds in the source, a source arc
+    # with the weighted degree as multiplier and a sink arc per node
+    H = nx.DiGraph()
+    H.add_nodes_from(["s", "t"])
+    total = sum(data["weight"] for _, _, data in G.edges(data=True))
+    for node in G.nodes():
+        if node in seeds:
+            H.add_edge("s", node, const=total + 1, mult=0)
+        else:
+            degree = sum(data["weight"] for data in G[node].values())
+            H.add_edge("s", node, const=0, mult=degree)
+            H.add_edge(node, "t", const=sink_weight[node], mult=0)
+    for u, v, data in G.edges(data=True):
+        H.add_edge(u, v, const=data["weight"], mult=0)
+        H.add_edge(v, u, const=data["weight"], mult=0)
+
+    breakpoints, cuts, _ = hpf(
+        H,
+        "s",
+        "t",
+        const_cap="const",
+        mult_cap="mult",
+        lambdaRange=[0.0, 1.0],
+        roundNegativeCapacity=False,
+    )
+    nodeLambdas = {
+        node: next((b for b, c in zip(breakpoints, cuts[node]) if c), float("inf"))
+        for node in G.nodes()
+    }
+    return breakpoints, nodeLambdas
+
+
+@pytest.mark.parametrize("seeds", [(), (0, 7)])
+def test_conductance_matches_hpf(seeds):
+    G = _random_undirected_graph(21)
+    rng = random.Random(22)
+    sink_weight = {node: rng.randint(0, 30) for node in G.nodes()}
+    expected_breakpoints, expected_lambdas = _conductance_as_parametric_cut(
+        G, sink_weight, seeds
+    )
+
+    breakpoints, nodeLambdas, _ = conductance(
+        G, "weight", seeds=seeds, sink_weight=sink_weight, lambdaRange=[0.0, 1.0]
+    )
+
+    assert breakpoints == pytest.approx(expected_breakpoints)
+    for node in G.nodes():
+        if node in seeds:
+            assert nodeLambdas[node] == 0.0
+        else:
+            assert nodeLambdas[node] == pytest.approx(expected_lambdas[node])
+
+
+def test_conductance_negative_weight_raises_valueerror():
+    G = _random_undirected_graph(23)
+    u, v = next(iter(G.edges()))
+    G[u][v]["weight"] = -1
+
+    with pytest.raises(ValueError):
+        conductance(G, "weight")